@@ -0,0 +1,6 @@
+#ifndef FREERTOS_IPC_BENCHMARK_H
+#define FREERTOS_IPC_BENCHMARK_H
+
+void freertos_ipc_benchmark_demo(void);
+
+#endif // FREERTOS_IPC_BENCHMARK_H 
\ No newline at end of file
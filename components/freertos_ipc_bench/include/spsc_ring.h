@@ -0,0 +1,118 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_err.h"
+
+/*
+ * Lock-free single-producer/single-consumer ring
+ * ----------------------------------------------
+ * One producer (a task or an ISR, on any core) and one consumer task exchange fixed-size items
+ * without a critical section: the producer only writes `head`, the consumer only writes `tail`,
+ * and the acquire/release ordering makes the item visible before the index that publishes it.
+ *
+ * The consumer sleeps on its task notification. It raises `waiting` before it checks the ring for
+ * the last time, and the producer notifies it only when it sees that flag after publishing an item,
+ * so a busy consumer costs the producer no FreeRTOS call at all.
+ *
+ * NOTE: Only ONE producer and ONE consumer. Two ISRs or two tasks pushing need a queue instead.
+ */
+typedef struct {
+    uint8_t *buf;
+    uint32_t item_size;
+    uint32_t mask;              // capacity - 1, the capacity is a power of two
+    TaskHandle_t consumer;
+    _Atomic uint32_t head;      // next slot to write, written by the producer only
+    _Atomic uint32_t tail;      // next slot to read, written by the consumer only
+    _Atomic uint32_t waiting;   // the consumer is about to block or blocked
+    uint32_t dropped;           // pushes that found the ring full, written by the producer only
+} spsc_ring_t;
+
+// Create a ring of `capacity` (rounded up to a power of two) items, the consumer task is the one woken by the pushes
+esp_err_t spsc_ring_create(uint32_t capacity, uint32_t item_size, TaskHandle_t consumer, spsc_ring_t **ret_ring);
+
+// Delete the ring, neither side may use it anymore
+void spsc_ring_delete(spsc_ring_t *ring);
+
+// Producer: copy an item into the ring, returns false (and counts a drop) if the ring is full.
+// Sets *woken if the consumer was woken, an ISR passes it to portYIELD_FROM_ISR.
+// NOTE: Always inlined, so that an IRAM ISR doesn't call into flash
+FORCE_INLINE_ATTR bool spsc_ring_push_common(spsc_ring_t *ring, const void *item, bool from_isr, BaseType_t *woken) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail > ring->mask) {
+        ring->dropped++;
+        return false;
+    }
+    memcpy(ring->buf + (head & ring->mask) * ring->item_size, item, ring->item_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    // Pairs with the fence in spsc_ring_wait: either the consumer sees the new head, or we see it waiting
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&ring->waiting, memory_order_relaxed)) {
+        atomic_store_explicit(&ring->waiting, 0, memory_order_relaxed);
+        if (from_isr) {
+            vTaskNotifyGiveFromISR(ring->consumer, woken);
+        } else {
+            xTaskNotifyGive(ring->consumer);
+        }
+    }
+    return true;
+}
+
+FORCE_INLINE_ATTR bool spsc_ring_push(spsc_ring_t *ring, const void *item) {
+    return spsc_ring_push_common(ring, item, false, NULL);
+}
+
+FORCE_INLINE_ATTR bool spsc_ring_push_from_isr(spsc_ring_t *ring, const void *item, BaseType_t *woken) {
+    return spsc_ring_push_common(ring, item, true, woken);
+}
+
+// Consumer: copy up to `max_items` items out of the ring in one go, returns the number copied
+static inline size_t spsc_ring_pop_batch(spsc_ring_t *ring, void *items, size_t max_items) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t count = head - tail;
+    if (count > max_items) {
+        count = max_items;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    // the run may wrap around the end of the buffer, copy it in two parts
+    uint32_t first = (ring->mask + 1) - (tail & ring->mask);
+    if (first > count) {
+        first = count;
+    }
+    memcpy(items, ring->buf + (tail & ring->mask) * ring->item_size, first * ring->item_size);
+    memcpy((uint8_t *)items + first * ring->item_size, ring->buf, (count - first) * ring->item_size);
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+    return count;
+}
+
+// Consumer: block until the ring is not empty, returns false on timeout
+bool spsc_ring_wait(spsc_ring_t *ring, TickType_t timeout);
+
+// Typed wrappers, e.g. SPSC_RING_DEFINE_TYPED(button_ring, button_event_t) gives
+// button_ring_push_from_isr(ring, &evt, &woken) and button_ring_pop_batch(ring, events, 8)
+#define SPSC_RING_DEFINE_TYPED(prefix, type)                                                                  \
+    static inline esp_err_t prefix##_create(uint32_t capacity, TaskHandle_t consumer, spsc_ring_t **ret_ring) { \
+        return spsc_ring_create(capacity, sizeof(type), consumer, ret_ring);                                  \
+    }                                                                                                         \
+    static inline bool prefix##_push(spsc_ring_t *ring, const type *item) {                                   \
+        return spsc_ring_push(ring, item);                                                                    \
+    }                                                                                                         \
+    FORCE_INLINE_ATTR bool prefix##_push_from_isr(spsc_ring_t *ring, const type *item, BaseType_t *woken) {   \
+        return spsc_ring_push_from_isr(ring, item, woken);                                                    \
+    }                                                                                                         \
+    static inline size_t prefix##_pop_batch(spsc_ring_t *ring, type *items, size_t max_items) {               \
+        return spsc_ring_pop_batch(ring, items, max_items);                                                   \
+    }
+
+#endif // SPSC_RING_H
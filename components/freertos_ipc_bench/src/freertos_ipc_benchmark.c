@@ -0,0 +1,544 @@
+/*
+ * FreeRTOS IPC Benchmark
+ * ----------------------
+ * Measures the latency of every FreeRTOS primitive shown by the other demos, so they can be compared
+ * before picking one for a hot path.
+ *
+ * WHAT: Two tasks ping-pong a token through a pair of channels of the same primitive, and the round trip
+ *       is timed with the CPU cycle counter. The setups are: both tasks on the same core, the tasks on
+ *       different cores, and a hardware timer ISR signaling a task (one way). Mutexes are timed as an
+ *       uncontended take/give pair, as they can't be given by another task.
+ * WHY: The cost of a primitive depends on the setup, e.g. a cross-core wakeup needs an inter-processor interrupt.
+ * WHEN: Run it on the target (or QEMU) before choosing how tasks and ISRs talk to each other.
+ *
+ * A last run fires the timer ISR at a high rate and compares xQueueSendFromISR with the lock-free
+ * SPSC ring (spsc_ring.h): cost of the send in the ISR, dropped events and wakeups of the consumer.
+ *
+ * NOTE: The results are printed as a table of p50/p99/max times and operations per second.
+ * The times are in CPU cycles, on the linux target (no cycle counter, no timer ISR) they are in nanoseconds.
+ */
+#include "freertos_ipc_benchmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/stream_buffer.h"
+#include "freertos/message_buffer.h"
+#include "freertos/event_groups.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "spsc_ring.h"
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "driver/gptimer.h"
+#endif
+
+// Timed round trips per primitive and setup, after a few untimed ones to warm up the caches
+#define IPC_BENCH_ITERATIONS 1000
+#define IPC_BENCH_WARMUP     16
+// The echo task runs one priority above the benchmark task, so a send switches to it at once
+#define IPC_BENCH_PRIORITY   10
+// Delay from starting the timer to its alarm ISR, in microseconds
+#define IPC_BENCH_ALARM_US   50
+// High rate run: events sent by the timer ISR, its period in microseconds, and the queue/ring length
+#define IPC_BENCH_BURST_EVENTS    20000
+#define IPC_BENCH_BURST_PERIOD_US 10
+#define IPC_BENCH_BURST_LENGTH    64
+// Event group bit used as the signal
+#define IPC_BENCH_EVENT_BIT  (1 << 0)
+
+static const char *TAG_IPC_BENCH = "freertos_ipc_bench";
+
+typedef enum {
+    IPC_QUEUE,
+    IPC_BINARY_SEMAPHORE,
+    IPC_COUNTING_SEMAPHORE,
+    IPC_QUEUE_SET,
+    IPC_STREAM_BUFFER,
+    IPC_MESSAGE_BUFFER,
+    IPC_TASK_NOTIFY,
+    IPC_EVENT_GROUP,
+    IPC_MUTEX,
+    IPC_RECURSIVE_MUTEX,
+    IPC_PRIMITIVE_MAX,
+} ipc_primitive_t;
+
+static const char *ipc_primitive_names[IPC_PRIMITIVE_MAX] = {
+    [IPC_QUEUE] = "queue",
+    [IPC_BINARY_SEMAPHORE] = "binary_sem",
+    [IPC_COUNTING_SEMAPHORE] = "counting_sem",
+    [IPC_QUEUE_SET] = "queue_set",
+    [IPC_STREAM_BUFFER] = "stream_buffer",
+    [IPC_MESSAGE_BUFFER] = "message_buffer",
+    [IPC_TASK_NOTIFY] = "task_notify",
+    [IPC_EVENT_GROUP] = "event_group",
+    [IPC_MUTEX] = "mutex",
+    [IPC_RECURSIVE_MUTEX] = "recursive_mutex",
+};
+
+// One direction of a ping-pong, only the handles of its primitive are used
+typedef struct {
+    ipc_primitive_t primitive;
+    QueueHandle_t queue;         // queue, semaphores and the member of the queue set
+    QueueSetHandle_t set;
+    StreamBufferHandle_t stream; // stream and message buffer
+    EventGroupHandle_t group;
+    TaskHandle_t receiver;       // task to notify
+} ipc_channel_t;
+
+typedef struct {
+    ipc_channel_t ping;
+    ipc_channel_t pong;
+    SemaphoreHandle_t echo_done;
+    volatile uint32_t isr_stamp;
+    uint32_t samples[IPC_BENCH_ITERATIONS];
+} ipc_bench_t;
+
+static ipc_bench_t s_bench;
+
+#if !CONFIG_IDF_TARGET_LINUX
+// High rate run, the ISR sends to the queue, or to the ring when it is set
+typedef struct {
+    QueueHandle_t queue;
+    spsc_ring_t *ring;
+    volatile uint32_t sent;       // events the ISR produced, delivered or dropped
+    volatile uint32_t dropped;
+    volatile uint32_t isr_cycles; // time spent in the send calls
+} ipc_burst_t;
+
+static ipc_burst_t s_burst;
+#endif
+
+#if CONFIG_IDF_TARGET_LINUX
+#define IPC_BENCH_UNIT "ns"
+static inline uint32_t ipc_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+
+static int64_t ipc_bench_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#else
+#define IPC_BENCH_UNIT "cycles"
+// NOTE: The cycle counter is per core, so only differences taken on the same core are meaningful
+static inline __attribute__((always_inline)) uint32_t ipc_bench_now(void) {
+    return esp_cpu_get_cycle_count();
+}
+
+static int64_t ipc_bench_time_us(void) {
+    return esp_timer_get_time();
+}
+#endif
+
+static bool ipc_channel_create(ipc_channel_t *ch, ipc_primitive_t primitive) {
+    *ch = (ipc_channel_t) { .primitive = primitive };
+    switch (primitive) {
+    case IPC_QUEUE:
+        ch->queue = xQueueCreate(1, sizeof(uint32_t));
+        return ch->queue != NULL;
+    case IPC_BINARY_SEMAPHORE:
+        ch->queue = xSemaphoreCreateBinary();
+        return ch->queue != NULL;
+    case IPC_COUNTING_SEMAPHORE:
+        ch->queue = xSemaphoreCreateCounting(4, 0);
+        return ch->queue != NULL;
+    case IPC_QUEUE_SET:
+        ch->queue = xQueueCreate(1, sizeof(uint32_t));
+        ch->set = xQueueCreateSet(1);
+        return ch->queue && ch->set && xQueueAddToSet(ch->queue, ch->set) == pdPASS;
+    case IPC_STREAM_BUFFER:
+        // trigger level of one token, so the receiver wakes up on every send
+        ch->stream = xStreamBufferCreate(4 * sizeof(uint32_t), sizeof(uint32_t));
+        return ch->stream != NULL;
+    case IPC_MESSAGE_BUFFER:
+        ch->stream = xMessageBufferCreate(4 * (sizeof(uint32_t) + sizeof(size_t)));
+        return ch->stream != NULL;
+    case IPC_EVENT_GROUP:
+        ch->group = xEventGroupCreate();
+        return ch->group != NULL;
+    default:
+        // task notifications need no object
+        return true;
+    }
+}
+
+static void ipc_channel_delete(ipc_channel_t *ch) {
+    // NOTE: A queue has to leave its set before it can be deleted
+    if (ch->set) {
+        xQueueRemoveFromSet(ch->queue, ch->set);
+        vQueueDelete(ch->set);
+    }
+    if (ch->queue) {
+        vQueueDelete(ch->queue);
+    }
+    if (ch->stream) {
+        vStreamBufferDelete(ch->stream);
+    }
+    if (ch->group) {
+        vEventGroupDelete(ch->group);
+    }
+    *ch = (ipc_channel_t) { 0 };
+}
+
+static void ipc_channel_send(ipc_channel_t *ch, uint32_t value) {
+    switch (ch->primitive) {
+    case IPC_QUEUE:
+    case IPC_QUEUE_SET:
+        xQueueSend(ch->queue, &value, portMAX_DELAY);
+        break;
+    case IPC_BINARY_SEMAPHORE:
+    case IPC_COUNTING_SEMAPHORE:
+        xSemaphoreGive(ch->queue);
+        break;
+    case IPC_STREAM_BUFFER:
+        xStreamBufferSend(ch->stream, &value, sizeof(value), portMAX_DELAY);
+        break;
+    case IPC_MESSAGE_BUFFER:
+        xMessageBufferSend(ch->stream, &value, sizeof(value), portMAX_DELAY);
+        break;
+    case IPC_TASK_NOTIFY:
+        xTaskNotifyGive(ch->receiver);
+        break;
+    case IPC_EVENT_GROUP:
+        xEventGroupSetBits(ch->group, IPC_BENCH_EVENT_BIT);
+        break;
+    default:
+        break;
+    }
+}
+
+static uint32_t ipc_channel_receive(ipc_channel_t *ch) {
+    uint32_t value = 0;
+    switch (ch->primitive) {
+    case IPC_QUEUE:
+        xQueueReceive(ch->queue, &value, portMAX_DELAY);
+        break;
+    case IPC_QUEUE_SET:
+        xQueueReceive(xQueueSelectFromSet(ch->set, portMAX_DELAY), &value, 0);
+        break;
+    case IPC_BINARY_SEMAPHORE:
+    case IPC_COUNTING_SEMAPHORE:
+        xSemaphoreTake(ch->queue, portMAX_DELAY);
+        break;
+    case IPC_STREAM_BUFFER:
+        xStreamBufferReceive(ch->stream, &value, sizeof(value), portMAX_DELAY);
+        break;
+    case IPC_MESSAGE_BUFFER:
+        xMessageBufferReceive(ch->stream, &value, sizeof(value), portMAX_DELAY);
+        break;
+    case IPC_TASK_NOTIFY:
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        break;
+    case IPC_EVENT_GROUP:
+        xEventGroupWaitBits(ch->group, IPC_BENCH_EVENT_BIT, pdTRUE, pdTRUE, portMAX_DELAY);
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+static int ipc_bench_compare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void ipc_bench_report(ipc_primitive_t primitive, const char *setup, int64_t elapsed_us) {
+    uint32_t *samples = s_bench.samples;
+    qsort(samples, IPC_BENCH_ITERATIONS, sizeof(uint32_t), ipc_bench_compare);
+    double ops_per_s = elapsed_us > 0 ? IPC_BENCH_ITERATIONS * 1e6 / elapsed_us : 0;
+    printf("%-16s %-12s %10lu %10lu %10lu %12.0f\n", ipc_primitive_names[primitive], setup,
+           (unsigned long)samples[IPC_BENCH_ITERATIONS / 2], (unsigned long)samples[IPC_BENCH_ITERATIONS * 99 / 100],
+           (unsigned long)samples[IPC_BENCH_ITERATIONS - 1], ops_per_s);
+}
+
+// Echo task: returns every ping as a pong
+static void ipc_bench_echo_task(void *pvParameter) {
+    for (int i = 0; i < IPC_BENCH_WARMUP + IPC_BENCH_ITERATIONS; i++) {
+        uint32_t value = ipc_channel_receive(&s_bench.ping);
+        ipc_channel_send(&s_bench.pong, value);
+    }
+    xSemaphoreGive(s_bench.echo_done);
+    vTaskDelete(NULL);
+}
+
+// Round trip through a pair of channels, with the echo task on the given core
+static void ipc_bench_ping_pong(ipc_primitive_t primitive, BaseType_t echo_core, const char *setup) {
+    if (!ipc_channel_create(&s_bench.ping, primitive) || !ipc_channel_create(&s_bench.pong, primitive)) {
+        ESP_LOGE(TAG_IPC_BENCH, "No memory for %s channels", ipc_primitive_names[primitive]);
+        goto out;
+    }
+    s_bench.pong.receiver = xTaskGetCurrentTaskHandle();
+    // NOTE: The handle is stored before the new task can run, so the first ping already knows its receiver
+    if (xTaskCreatePinnedToCore(ipc_bench_echo_task, "ipc_bench_echo", 2048, NULL, IPC_BENCH_PRIORITY + 1,
+                                &s_bench.ping.receiver, echo_core) != pdPASS) {
+        ESP_LOGE(TAG_IPC_BENCH, "Failed to create the echo task");
+        goto out;
+    }
+
+    int64_t start_us = 0;
+    for (int i = 0; i < IPC_BENCH_WARMUP + IPC_BENCH_ITERATIONS; i++) {
+        if (i == IPC_BENCH_WARMUP) {
+            start_us = ipc_bench_time_us();
+        }
+        uint32_t t0 = ipc_bench_now();
+        ipc_channel_send(&s_bench.ping, i);
+        ipc_channel_receive(&s_bench.pong);
+        uint32_t t1 = ipc_bench_now();
+        if (i >= IPC_BENCH_WARMUP) {
+            s_bench.samples[i - IPC_BENCH_WARMUP] = t1 - t0;
+        }
+    }
+    int64_t elapsed_us = ipc_bench_time_us() - start_us;
+    xSemaphoreTake(s_bench.echo_done, portMAX_DELAY);
+    ipc_bench_report(primitive, setup, elapsed_us);
+out:
+    ipc_channel_delete(&s_bench.ping);
+    ipc_channel_delete(&s_bench.pong);
+}
+
+// Uncontended take and give of a mutex in the same task
+static void ipc_bench_lock(ipc_primitive_t primitive) {
+    bool recursive = primitive == IPC_RECURSIVE_MUTEX;
+    SemaphoreHandle_t mutex = recursive ? xSemaphoreCreateRecursiveMutex() : xSemaphoreCreateMutex();
+    if (!mutex) {
+        ESP_LOGE(TAG_IPC_BENCH, "No memory for %s", ipc_primitive_names[primitive]);
+        return;
+    }
+    int64_t start_us = 0;
+    for (int i = 0; i < IPC_BENCH_WARMUP + IPC_BENCH_ITERATIONS; i++) {
+        if (i == IPC_BENCH_WARMUP) {
+            start_us = ipc_bench_time_us();
+        }
+        uint32_t t0 = ipc_bench_now();
+        if (recursive) {
+            xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+            xSemaphoreGiveRecursive(mutex);
+        } else {
+            xSemaphoreTake(mutex, portMAX_DELAY);
+            xSemaphoreGive(mutex);
+        }
+        uint32_t t1 = ipc_bench_now();
+        if (i >= IPC_BENCH_WARMUP) {
+            s_bench.samples[i - IPC_BENCH_WARMUP] = t1 - t0;
+        }
+    }
+    ipc_bench_report(primitive, "uncontended", ipc_bench_time_us() - start_us);
+    vSemaphoreDelete(mutex);
+}
+
+#if !CONFIG_IDF_TARGET_LINUX
+static void IRAM_ATTR ipc_channel_send_from_isr(ipc_channel_t *ch, BaseType_t *woken) {
+    uint32_t value = 0;
+    switch (ch->primitive) {
+    case IPC_QUEUE:
+    case IPC_QUEUE_SET:
+        xQueueSendFromISR(ch->queue, &value, woken);
+        break;
+    case IPC_BINARY_SEMAPHORE:
+    case IPC_COUNTING_SEMAPHORE:
+        xSemaphoreGiveFromISR(ch->queue, woken);
+        break;
+    case IPC_STREAM_BUFFER:
+        xStreamBufferSendFromISR(ch->stream, &value, sizeof(value), woken);
+        break;
+    case IPC_MESSAGE_BUFFER:
+        xMessageBufferSendFromISR(ch->stream, &value, sizeof(value), woken);
+        break;
+    case IPC_TASK_NOTIFY:
+        vTaskNotifyGiveFromISR(ch->receiver, woken);
+        break;
+    case IPC_EVENT_GROUP:
+        // NOTE: The bits are set by the timer service task, the ISR only queues the request
+        xEventGroupSetBitsFromISR(ch->group, IPC_BENCH_EVENT_BIT, woken);
+        break;
+    default:
+        break;
+    }
+}
+
+// Timer alarm ISR: stamps the event and signals the benchmark task
+static bool IRAM_ATTR ipc_bench_alarm_cb(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+    BaseType_t woken = pdFALSE;
+    s_bench.isr_stamp = ipc_bench_now();
+    ipc_channel_send_from_isr(&s_bench.ping, &woken);
+    // Returning true makes the driver yield to the woken task at the end of the ISR
+    return woken == pdTRUE;
+}
+
+// One way from the alarm ISR to this task, the timer interrupt is installed on the core of this task
+static void ipc_bench_isr(gptimer_handle_t timer, ipc_primitive_t primitive) {
+    if (!ipc_channel_create(&s_bench.ping, primitive)) {
+        ESP_LOGE(TAG_IPC_BENCH, "No memory for %s channel", ipc_primitive_names[primitive]);
+        goto out;
+    }
+    s_bench.ping.receiver = xTaskGetCurrentTaskHandle();
+    int64_t start_us = 0;
+    for (int i = 0; i < IPC_BENCH_WARMUP + IPC_BENCH_ITERATIONS; i++) {
+        if (i == IPC_BENCH_WARMUP) {
+            start_us = ipc_bench_time_us();
+        }
+        gptimer_set_raw_count(timer, 0);
+        gptimer_start(timer);
+        ipc_channel_receive(&s_bench.ping);
+        uint32_t t1 = ipc_bench_now();
+        gptimer_stop(timer);
+        if (i >= IPC_BENCH_WARMUP) {
+            s_bench.samples[i - IPC_BENCH_WARMUP] = t1 - s_bench.isr_stamp;
+        }
+    }
+    // the alarm delay is part of every event, so the rate tells the overhead on top of it
+    ipc_bench_report(primitive, "isr_to_task", ipc_bench_time_us() - start_us);
+out:
+    ipc_channel_delete(&s_bench.ping);
+}
+
+// Periodic timer ISR of the high rate run
+static bool IRAM_ATTR ipc_bench_burst_cb(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx) {
+    if (s_burst.sent >= IPC_BENCH_BURST_EVENTS) {
+        return false;
+    }
+    BaseType_t woken = pdFALSE;
+    uint32_t value = s_burst.sent;
+    bool sent;
+    uint32_t t0 = ipc_bench_now();
+    if (s_burst.ring) {
+        sent = spsc_ring_push_from_isr(s_burst.ring, &value, &woken);
+    } else {
+        sent = xQueueSendFromISR(s_burst.queue, &value, &woken) == pdTRUE;
+    }
+    s_burst.isr_cycles += ipc_bench_now() - t0;
+    s_burst.sent++;
+    if (!sent) {
+        s_burst.dropped++;
+    }
+    return woken == pdTRUE;
+}
+
+// Drain everything the ISR sends at IPC_BENCH_BURST_PERIOD_US, through a queue or the SPSC ring
+static void ipc_bench_burst(gptimer_handle_t timer, bool use_ring) {
+    s_burst = (ipc_burst_t) { 0 };
+    if (use_ring) {
+        if (spsc_ring_create(IPC_BENCH_BURST_LENGTH, sizeof(uint32_t), xTaskGetCurrentTaskHandle(), &s_burst.ring) != ESP_OK) {
+            ESP_LOGE(TAG_IPC_BENCH, "No memory for the ring");
+            return;
+        }
+    } else {
+        s_burst.queue = xQueueCreate(IPC_BENCH_BURST_LENGTH, sizeof(uint32_t));
+        if (!s_burst.queue) {
+            ESP_LOGE(TAG_IPC_BENCH, "No memory for the queue");
+            return;
+        }
+    }
+    uint32_t received = 0;
+    uint32_t wakeups = 0;
+    uint32_t batch[16];
+    int64_t start_us = ipc_bench_time_us();
+    gptimer_set_raw_count(timer, 0);
+    gptimer_start(timer);
+    while (received + s_burst.dropped < IPC_BENCH_BURST_EVENTS) {
+        if (use_ring) {
+            // one wakeup, then take everything that piled up in batches
+            if (!spsc_ring_wait(s_burst.ring, pdMS_TO_TICKS(100))) {
+                continue;
+            }
+            wakeups++;
+            size_t n;
+            while ((n = spsc_ring_pop_batch(s_burst.ring, batch, 16)) > 0) {
+                received += n;
+            }
+        } else {
+            if (xQueueReceive(s_burst.queue, &batch[0], pdMS_TO_TICKS(100)) != pdTRUE) {
+                continue;
+            }
+            wakeups++;
+            received++;
+            while (xQueueReceive(s_burst.queue, &batch[0], 0) == pdTRUE) {
+                received++;
+            }
+        }
+    }
+    int64_t elapsed_us = ipc_bench_time_us() - start_us;
+    gptimer_stop(timer);
+    printf("%-16s %10lu %10lu %10lu %12lu %12.0f\n", use_ring ? "spsc_ring" : "queue",
+           (unsigned long)received, (unsigned long)s_burst.dropped, (unsigned long)wakeups,
+           (unsigned long)(s_burst.isr_cycles / IPC_BENCH_BURST_EVENTS), received * 1e6 / elapsed_us);
+    if (use_ring) {
+        spsc_ring_delete(s_burst.ring);
+    } else {
+        vQueueDelete(s_burst.queue);
+    }
+}
+#endif // !CONFIG_IDF_TARGET_LINUX
+
+static void ipc_bench_task(void *pvParameter) {
+    s_bench.echo_done = xSemaphoreCreateBinary();
+    printf("%-16s %-12s %10s %10s %10s %12s\n", "primitive", "setup", "p50", "p99", "max", "ops/s");
+    printf("(times in %s, %d iterations each)\n", IPC_BENCH_UNIT, IPC_BENCH_ITERATIONS);
+    for (int p = 0; p < IPC_MUTEX; p++) {
+        ipc_bench_ping_pong(p, 0, "same_core");
+        if (portNUM_PROCESSORS > 1) {
+            ipc_bench_ping_pong(p, 1, "cross_core");
+        }
+    }
+    ipc_bench_lock(IPC_MUTEX);
+    ipc_bench_lock(IPC_RECURSIVE_MUTEX);
+
+#if !CONFIG_IDF_TARGET_LINUX
+    gptimer_handle_t timer = NULL;
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000, // 1 tick = 1us
+    };
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = ipc_bench_alarm_cb,
+    };
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = IPC_BENCH_ALARM_US,
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &timer));
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(timer, &cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(timer, &alarm_config));
+    ESP_ERROR_CHECK(gptimer_enable(timer));
+    for (int p = 0; p < IPC_MUTEX; p++) {
+        ipc_bench_isr(timer, p);
+    }
+    ESP_ERROR_CHECK(gptimer_disable(timer));
+
+    // Callbacks can only be changed while the timer is disabled
+    printf("\nISR at %d us period, %d events, queue/ring length %d\n", IPC_BENCH_BURST_PERIOD_US, IPC_BENCH_BURST_EVENTS,
+           IPC_BENCH_BURST_LENGTH);
+    printf("%-16s %10s %10s %10s %12s %12s\n", "backend", "received", "dropped", "wakeups", "cycles/send", "events/s");
+    cbs.on_alarm = ipc_bench_burst_cb;
+    alarm_config.alarm_count = IPC_BENCH_BURST_PERIOD_US;
+    alarm_config.flags.auto_reload_on_alarm = true;
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(timer, &cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(timer, &alarm_config));
+    ESP_ERROR_CHECK(gptimer_enable(timer));
+    ipc_bench_burst(timer, false);
+    ipc_bench_burst(timer, true);
+    ESP_ERROR_CHECK(gptimer_disable(timer));
+    ESP_ERROR_CHECK(gptimer_del_timer(timer));
+#endif
+
+    vSemaphoreDelete(s_bench.echo_done);
+    ESP_LOGI(TAG_IPC_BENCH, "IPC benchmark done");
+    vTaskDelete(NULL);
+}
+
+void freertos_ipc_benchmark_demo(void) {
+    // NOTE: The benchmark task is pinned to core 0, so that the same core and cross core setups are well defined
+    xTaskCreatePinnedToCore(ipc_bench_task, "ipc_bench", 4096, NULL, IPC_BENCH_PRIORITY, NULL, 0);
+}
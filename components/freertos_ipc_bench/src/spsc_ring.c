@@ -0,0 +1,71 @@
+/*
+ * Lock-free SPSC Ring
+ * -------------------
+ * See spsc_ring.h. The push and pop paths are inline in the header, this file holds the setup and the
+ * blocking wait of the consumer.
+ */
+#include "spsc_ring.h"
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_check.h"
+
+static const char *TAG_SPSC_RING = "spsc_ring";
+
+esp_err_t spsc_ring_create(uint32_t capacity, uint32_t item_size, TaskHandle_t consumer, spsc_ring_t **ret_ring) {
+    ESP_RETURN_ON_FALSE(capacity && capacity <= (1UL << 16) && item_size && consumer && ret_ring, ESP_ERR_INVALID_ARG,
+                        TAG_SPSC_RING, "invalid argument");
+    // a power of two capacity turns the wrap-around into a mask, and the free running indexes stay valid across overflow
+    uint32_t slots = 1;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+    // NOTE: ISRs and the other core touch the ring, so keep it in internal RAM
+    spsc_ring_t *ring = heap_caps_calloc(1, sizeof(spsc_ring_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_RETURN_ON_FALSE(ring, ESP_ERR_NO_MEM, TAG_SPSC_RING, "no mem for ring");
+    ring->buf = heap_caps_calloc(slots, item_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!ring->buf) {
+        free(ring);
+        return ESP_ERR_NO_MEM;
+    }
+    ring->item_size = item_size;
+    ring->mask = slots - 1;
+    ring->consumer = consumer;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->waiting, 0);
+    *ret_ring = ring;
+    return ESP_OK;
+}
+
+void spsc_ring_delete(spsc_ring_t *ring) {
+    if (!ring) {
+        return;
+    }
+    free(ring->buf);
+    free(ring);
+}
+
+static inline bool spsc_ring_is_empty(spsc_ring_t *ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire) == atomic_load_explicit(&ring->tail, memory_order_relaxed);
+}
+
+bool spsc_ring_wait(spsc_ring_t *ring, TickType_t timeout) {
+    while (spsc_ring_is_empty(ring)) {
+        atomic_store_explicit(&ring->waiting, 1, memory_order_relaxed);
+        // Pairs with the fence in the push: either the producer sees `waiting`, or we see its item here
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!spsc_ring_is_empty(ring)) {
+            atomic_store_explicit(&ring->waiting, 0, memory_order_relaxed);
+            break;
+        }
+        // FreeRTOS API: ulTaskNotifyTake - a notification left over from an earlier push only causes one more look
+        uint32_t notified = ulTaskNotifyTake(pdTRUE, timeout);
+        atomic_store_explicit(&ring->waiting, 0, memory_order_relaxed);
+        if (notified == 0) {
+            return !spsc_ring_is_empty(ring);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,6 @@
+#include "freertos_ipc_benchmark.h"
+
+void app_main(void) {
+    // the benchmark runs in its own task and prints its table when done
+    freertos_ipc_benchmark_demo();
+}
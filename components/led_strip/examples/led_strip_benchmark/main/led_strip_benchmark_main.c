@@ -0,0 +1,258 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "led_strip.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "esp_cpu.h"
+#endif
+
+// Number of pixels processed by each measurement, the iterations are derived from the strip length
+#define BENCH_PIXELS_PER_RUN (1024 * 1024)
+
+static const char *TAG = "benchmark";
+
+typedef enum {
+    BENCH_SET_PIXEL,
+    BENCH_SET_PIXELS,
+    BENCH_FILL,
+    BENCH_WRITE_FRAME,
+    BENCH_SET_PIXELS_HSV,
+    BENCH_SPI_ENCODE,
+    BENCH_RMT_SYMBOLS,
+    BENCH_RMT_SYMBOLS_BRIGHTNESS,
+    BENCH_BLEND_REPLACE,
+    BENCH_BLEND_ADD,
+    BENCH_BLEND_ALPHA,
+    BENCH_MAX,
+} bench_kind_t;
+
+static const char *s_bench_names[BENCH_MAX] = {
+    [BENCH_SET_PIXEL] = "set_pixel",
+    [BENCH_SET_PIXELS] = "set_pixels",
+    [BENCH_FILL] = "fill",
+    [BENCH_WRITE_FRAME] = "write_frame",
+    [BENCH_SET_PIXELS_HSV] = "set_pixels_hsv",
+    [BENCH_SPI_ENCODE] = "spi_encode",
+    [BENCH_RMT_SYMBOLS] = "rmt_symbols",
+    [BENCH_RMT_SYMBOLS_BRIGHTNESS] = "rmt_symbols_brightness",
+    [BENCH_BLEND_REPLACE] = "blend_replace",
+    [BENCH_BLEND_ADD] = "blend_add",
+    [BENCH_BLEND_ALPHA] = "blend_alpha",
+};
+
+static const uint32_t s_strip_lengths[] = {16, 64, 256, 1024};
+
+static const char *s_model_names[LED_MODEL_INVALID] = {
+    [LED_MODEL_WS2812] = "WS2812",
+    [LED_MODEL_SK6812] = "SK6812",
+    [LED_MODEL_WS2811] = "WS2811",
+    [LED_MODEL_WS2813] = "WS2813",
+    [LED_MODEL_WS2815] = "WS2815",
+    [LED_MODEL_APA106] = "APA106",
+};
+
+// reset times to compare with the default of each model, 0 stands for the default
+static const uint32_t s_reset_times_us[] = {0, 80};
+
+static int64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static esp_err_t bench_run(bench_kind_t kind, led_pixel_format_t format, uint32_t leds)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = leds,
+        .led_pixel_format = format,
+        .led_model = LED_MODEL_WS2812,
+    };
+    led_strip_capture_config_t capture_config = {
+        .waveform = kind == BENCH_SPI_ENCODE ? LED_STRIP_CAPTURE_WAVEFORM_SPI : LED_STRIP_CAPTURE_WAVEFORM_RMT,
+    };
+    led_strip_handle_t strip = NULL;
+    ESP_ERROR_CHECK(led_strip_new_capture_device(&strip_config, &capture_config, &strip));
+    if (kind == BENCH_RMT_SYMBOLS_BRIGHTNESS) {
+        ESP_ERROR_CHECK(led_strip_set_brightness(strip, 128));
+    }
+
+    uint32_t bytes_per_pixel = format == LED_PIXEL_FORMAT_GRBW ? 4 : 3;
+    uint8_t *rgb = malloc(leds * 3);
+    uint8_t *frame = malloc(leds * bytes_per_pixel);
+    led_color_hsv_t *hsv = malloc(leds * sizeof(led_color_hsv_t));
+    if (!rgb || !frame || !hsv) {
+        free(rgb);
+        free(frame);
+        free(hsv);
+        led_strip_del(strip);
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint32_t i = 0; i < leds; i++) {
+        rgb[i * 3 + 0] = i;
+        rgb[i * 3 + 1] = i * 3;
+        rgb[i * 3 + 2] = i * 7;
+        hsv[i] = (led_color_hsv_t) {
+            .hue = i % 360, .saturation = 255 - (i & 0x7F), .value = 128 + (i & 0x7F),
+        };
+    }
+    // a frame already laid out in the pixel format of the strip
+    for (uint32_t i = 0; i < leds * bytes_per_pixel; i++) {
+        frame[i] = i * 5;
+    }
+    // start from a drawn frame, so that the encoders see the same data on every iteration
+    ESP_ERROR_CHECK(led_strip_set_pixels(strip, 0, leds, rgb));
+
+    // a half transparent layer over a background, blended again in full on every iteration
+    led_strip_compositor_handle_t compositor = NULL;
+    if (kind >= BENCH_BLEND_REPLACE) {
+        led_strip_compositor_config_t compositor_config = {
+            .strip = strip,
+            .max_leds = leds,
+            .num_layers = 2,
+            .led_pixel_format = format,
+        };
+        ESP_ERROR_CHECK(led_strip_new_compositor(&compositor_config, &compositor));
+        uint32_t *background = NULL;
+        uint32_t *overlay = NULL;
+        ESP_ERROR_CHECK(led_strip_compositor_get_layer_buffer(compositor, 0, &background));
+        ESP_ERROR_CHECK(led_strip_compositor_get_layer_buffer(compositor, 1, &overlay));
+        for (uint32_t i = 0; i < leds; i++) {
+            background[i] = LED_STRIP_COMPOSITOR_RGBW(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2], i);
+            overlay[i] = LED_STRIP_COMPOSITOR_RGBW(rgb[i * 3 + 2], rgb[i * 3], rgb[i * 3 + 1], i * 5);
+        }
+        led_strip_blend_mode_t mode = kind == BENCH_BLEND_REPLACE ? LED_STRIP_BLEND_REPLACE :
+                                      kind == BENCH_BLEND_ADD ? LED_STRIP_BLEND_ADD : LED_STRIP_BLEND_ALPHA;
+        ESP_ERROR_CHECK(led_strip_compositor_set_layer(compositor, 1, mode, 128));
+    }
+
+    uint32_t iterations = BENCH_PIXELS_PER_RUN / leds;
+    int64_t start = bench_now_ns();
+#if !CONFIG_IDF_TARGET_LINUX
+    // NOTE: The cycle counter is per core, app_main runs pinned to one core so the difference is meaningful
+    uint32_t start_cycles = esp_cpu_get_cycle_count();
+#endif
+    for (uint32_t n = 0; n < iterations; n++) {
+        switch (kind) {
+        case BENCH_SET_PIXEL:
+            for (uint32_t i = 0; i < leds; i++) {
+                led_strip_set_pixel(strip, i, rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+            }
+            break;
+        case BENCH_SET_PIXELS:
+            led_strip_set_pixels(strip, 0, leds, rgb);
+            break;
+        case BENCH_FILL:
+            led_strip_fill(strip, 0, leds, n, n * 3, n * 7);
+            break;
+        case BENCH_WRITE_FRAME:
+            led_strip_write_frame(strip, frame, leds * bytes_per_pixel);
+            break;
+        case BENCH_SET_PIXELS_HSV:
+            led_strip_set_pixels_hsv(strip, 0, leds, hsv);
+            break;
+        case BENCH_BLEND_REPLACE:
+        case BENCH_BLEND_ADD:
+        case BENCH_BLEND_ALPHA:
+            led_strip_compositor_mark_dirty(compositor, 1, 0, leds);
+            led_strip_compositor_render(compositor, NULL);
+            break;
+        default:
+            led_strip_refresh(strip);
+            break;
+        }
+    }
+#if !CONFIG_IDF_TARGET_LINUX
+    uint32_t elapsed_cycles = esp_cpu_get_cycle_count() - start_cycles;
+#endif
+    int64_t elapsed_ns = bench_now_ns() - start;
+
+    uint64_t pixels = (uint64_t)iterations * leds;
+    double pixels_per_s = elapsed_ns > 0 ? pixels * 1e9 / elapsed_ns : 0;
+    // one JSON object per line, so that the results can be collected by a script
+    printf("{\"bench\":\"%s\",\"format\":\"%s\",\"leds\":%lu,\"pixels\":%llu,\"ns\":%lld,\"pixels_per_s\":%.0f",
+           s_bench_names[kind], format == LED_PIXEL_FORMAT_GRBW ? "GRBW" : "GRB", (unsigned long)leds,
+           (unsigned long long)pixels, (long long)elapsed_ns, pixels_per_s);
+#if !CONFIG_IDF_TARGET_LINUX
+    // the host has no portable cycle counter, there the field is left out
+    printf(",\"cycles_per_pixel\":%.2f", (double)elapsed_cycles / pixels);
+#endif
+    printf("}\n");
+
+    if (compositor) {
+        ESP_ERROR_CHECK(led_strip_del_compositor(compositor));
+    }
+    free(rgb);
+    free(frame);
+    free(hsv);
+    return led_strip_del(strip);
+}
+
+// the frame rate limit of the wire, worked out from the duration of the captured RMT symbols
+static esp_err_t bench_wire_fps(led_model_t model, uint32_t leds, uint32_t reset_us)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = leds,
+        .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+        .led_model = model,
+        .reset_us = reset_us,
+    };
+    led_strip_capture_config_t capture_config = {
+        .waveform = LED_STRIP_CAPTURE_WAVEFORM_RMT,
+    };
+    led_strip_handle_t strip = NULL;
+    ESP_ERROR_CHECK(led_strip_new_capture_device(&strip_config, &capture_config, &strip));
+    // a frame of half lit pixels, so that the bits 0 and 1 are evenly mixed
+    ESP_ERROR_CHECK(led_strip_fill(strip, 0, leds, 0x0F, 0x0F, 0x0F));
+    ESP_ERROR_CHECK(led_strip_refresh(strip));
+
+    const led_strip_capture_symbol_t *symbols = NULL;
+    size_t num_symbols = 0;
+    ESP_ERROR_CHECK(led_strip_capture_get_symbols(strip, &symbols, &num_symbols));
+    uint64_t ticks = 0;
+    for (size_t i = 0; i < num_symbols; i++) {
+        ticks += symbols[i].duration0 + symbols[i].duration1;
+    }
+    // the capture backend records at the default 10MHz resolution
+    double frame_us = ticks / 10.0;
+    uint32_t actual_reset_us = (symbols[num_symbols - 1].duration0 + symbols[num_symbols - 1].duration1) / 10;
+    printf("{\"bench\":\"wire_fps\",\"model\":\"%s\",\"leds\":%lu,\"reset_us\":%lu,\"frame_us\":%.1f,\"max_fps\":%.1f}\n",
+           s_model_names[model], (unsigned long)leds, (unsigned long)actual_reset_us, frame_us, 1e6 / frame_us);
+    return led_strip_del(strip);
+}
+
+void app_main(void)
+{
+    ESP_LOGI(TAG, "Start led_strip benchmark, %d pixels per run", BENCH_PIXELS_PER_RUN);
+    for (int kind = 0; kind < BENCH_MAX; kind++) {
+        for (int format = 0; format < LED_PIXEL_FORMAT_INVALID; format++) {
+            for (size_t i = 0; i < sizeof(s_strip_lengths) / sizeof(s_strip_lengths[0]); i++) {
+                ESP_ERROR_CHECK(bench_run(kind, format, s_strip_lengths[i]));
+            }
+        }
+    }
+    for (int model = 0; model < LED_MODEL_INVALID; model++) {
+        // clocked models don't have a one-wire waveform
+        if (!s_model_names[model]) {
+            continue;
+        }
+        for (size_t r = 0; r < sizeof(s_reset_times_us) / sizeof(s_reset_times_us[0]); r++) {
+            for (size_t i = 0; i < sizeof(s_strip_lengths) / sizeof(s_strip_lengths[0]); i++) {
+                ESP_ERROR_CHECK(bench_wire_fps(model, s_strip_lengths[i], s_reset_times_us[r]));
+            }
+        }
+    }
+    ESP_LOGI(TAG, "Benchmark done");
+#if CONFIG_IDF_TARGET_LINUX
+    exit(0);
+#endif
+}
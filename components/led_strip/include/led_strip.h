@@ -0,0 +1,337 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "esp_idf_version.h"
+#include "led_strip_types.h"
+#include "led_strip_capture.h"
+#include "led_strip_compositor.h"
+#include "led_strip_matrix.h"
+
+// the linux target has no peripheral, only the capture backend is available there
+#if !CONFIG_IDF_TARGET_LINUX
+#include "led_strip_rmt.h"
+#include "led_strip_frame_engine.h"
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+#include "led_strip_spi.h"
+#include "led_strip_spi_clocked.h"
+#endif
+#endif // !CONFIG_IDF_TARGET_LINUX
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set RGB for a specific pixel
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param red: red part of color
+ * @param green: green part of color
+ * @param blue: blue part of color
+ *
+ * @return
+ *      - ESP_OK: Set RGB for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set RGB for a specific pixel failed because of invalid parameters
+ *      - ESP_FAIL: Set RGB for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue);
+
+/**
+ * @brief Set RGBW for a specific pixel
+ *
+ * @note Only call this function if your led strip does have the white component (e.g. SK6812-RGBW)
+ * @note Also see `led_strip_set_pixel` if you only want to specify the RGB part of the color and bypass the white component
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param red: red part of color
+ * @param green: green part of color
+ * @param blue: blue part of color
+ * @param white: separate white component
+ *
+ * @return
+ *      - ESP_OK: Set RGBW color for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set RGBW color for a specific pixel failed because of an invalid argument
+ *      - ESP_FAIL: Set RGBW color for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel_rgbw(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white);
+
+/**
+ * @brief Set HSV for a specific pixel
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param hue: hue part of color (0 - 360)
+ * @param saturation: saturation part of color (0 - 255, rescaled from 0 - 1. e.g. saturation = 0.5, rescaled to 127)
+ * @param value: value part of color (0 - 255, rescaled from 0 - 1. e.g. value = 0.5, rescaled to 127)
+ *
+ * @return
+ *      - ESP_OK: Set HSV color for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set HSV color for a specific pixel failed because of an invalid argument
+ *      - ESP_FAIL: Set HSV color for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint16_t hue, uint8_t saturation, uint8_t value);
+
+/**
+ * @brief Set RGB for a range of pixels
+ *
+ * @note The range is validated once and the colors are written straight into the strip's pixel buffer,
+ *       which is much cheaper than calling `led_strip_set_pixel` for every pixel.
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param count: number of pixels to set
+ * @param rgb: packed colors, 3 bytes per pixel in the order of R, G, B
+ *
+ * @return
+ *      - ESP_OK: Set RGB for the pixel range successfully
+ *      - ESP_ERR_INVALID_ARG: Set RGB for the pixel range failed because of invalid parameters
+ *      - ESP_FAIL: Set RGB for the pixel range failed because other error occurred
+ */
+esp_err_t led_strip_set_pixels(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint8_t *rgb);
+
+/**
+ * @brief Set the same RGB color for a range of pixels
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param count: number of pixels to set
+ * @param red: red part of color
+ * @param green: green part of color
+ * @param blue: blue part of color
+ *
+ * @return
+ *      - ESP_OK: Fill the pixel range successfully
+ *      - ESP_ERR_INVALID_ARG: Fill the pixel range failed because of invalid parameters
+ *      - ESP_FAIL: Fill the pixel range failed because other error occurred
+ */
+esp_err_t led_strip_fill(led_strip_handle_t strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue);
+
+/**
+ * @brief Copy a whole frame into the LED strip
+ *
+ * @note The frame must already be laid out in the strip's pixel format (GRB or GRBW), starting from pixel 0.
+ *
+ * @param strip: LED strip
+ * @param frame: frame data
+ * @param size: size of the frame in bytes, must be a multiple of the bytes per pixel and not exceed the strip length
+ *
+ * @return
+ *      - ESP_OK: Write the frame successfully
+ *      - ESP_ERR_INVALID_ARG: Write the frame failed because of invalid parameters
+ *      - ESP_ERR_NOT_SUPPORTED: Write the frame failed because the backend doesn't support it
+ *      - ESP_FAIL: Write the frame failed because other error occurred
+ */
+esp_err_t led_strip_write_frame(led_strip_handle_t strip, const uint8_t *frame, size_t size);
+
+/**
+ * @brief Set HSV for a range of pixels
+ *
+ * @note The colors are converted with the same integer kernel as `led_strip_set_pixel_hsv`, and written with `led_strip_set_pixels`
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param count: number of pixels to set
+ * @param hsv: array of `count` HSV colors
+ *
+ * @return
+ *      - ESP_OK: Set HSV color for the pixel range successfully
+ *      - ESP_ERR_INVALID_ARG: Set HSV color for the pixel range failed because of invalid parameters
+ *      - ESP_FAIL: Set HSV color for the pixel range failed because other error occurred
+ */
+esp_err_t led_strip_set_pixels_hsv(led_strip_handle_t strip, uint32_t start, uint32_t count, const led_color_hsv_t *hsv);
+
+/**
+ * @brief Get the pixel buffer of the LED strip, so that a renderer can draw into it in place
+ *
+ * @note The buffer is laid out in the pixel format of the strip (GRB or GRBW), and `led_strip_refresh` sends it out without any intermediate copy
+ * @note In double buffer mode the buffers are swapped by `led_strip_refresh_async`, so get the buffer again after each asynchronous refresh.
+ *       The buffer then holds frame N-1, not frame N that was just sent out
+ *
+ * @param strip: LED strip
+ * @param ret_buf: returned pixel buffer
+ * @param ret_size: returned size of the pixel buffer in bytes
+ *
+ * @return
+ *      - ESP_OK: Get the pixel buffer successfully
+ *      - ESP_ERR_INVALID_ARG: Get the pixel buffer failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Get the pixel buffer failed because the backend keeps the pixels in an encoded form
+ */
+esp_err_t led_strip_get_buffer(led_strip_handle_t strip, uint8_t **ret_buf, size_t *ret_size);
+
+/**
+ * @brief Send only the leading pixels of the strip, so that the wire time of a refresh scales with the lit content
+ *
+ * @note The length is persistent, it applies to all the following refreshes until it's changed again
+ * @note When the length shrinks, the next refresh still covers the pixels sent by the previous frame and blanks the ones beyond the new length,
+ *       after which they are no longer sent. They are sent as zeros, the pixel buffer keeps its content
+ *       (except for the SPI backend without streaming, whose encoded frame is blanked in place)
+ *
+ * @param strip: LED strip
+ * @param length: number of pixels to send, from 1 to the maximum number of LEDs
+ *
+ * @return
+ *      - ESP_OK: Set the active length successfully
+ *      - ESP_ERR_INVALID_ARG: Set the active length failed because of invalid parameters
+ *      - ESP_ERR_NOT_SUPPORTED: Set the active length failed because the backend always sends the whole strip
+ */
+esp_err_t led_strip_set_active_length(led_strip_handle_t strip, uint32_t length);
+
+/**
+ * @brief Refresh memory colors to LEDs
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Refresh successfully
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ *
+ * @note:
+ *      After updating the LED colors in the memory, a following invocation of this API is needed to flush colors to strip.
+ */
+esp_err_t led_strip_refresh(led_strip_handle_t strip);
+
+/**
+ * @brief Start flushing the drawn frame to LEDs and return at once
+ *
+ * @note The front and back buffers are swapped: the frame just drawn is sent out while the caller renders the next frame into the other buffer.
+ * @note After the swap the drawing buffer holds frame N-1, not frame N that was just sent out. A renderer that only updates the pixels
+ *       that changed since the last frame must redraw the whole frame, or copy frame N over first (after `led_strip_wait_refresh_done`)
+ * @note Backends without asynchronous support, and RMT strips created without `double_buffer`, fall back to `led_strip_refresh`.
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Start the refresh successfully
+ *      - ESP_ERR_INVALID_STATE: Start the refresh failed because the strip is refreshed through a RMT strip group
+ *      - ESP_FAIL: Start the refresh failed because some other error occurred
+ */
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip);
+
+/**
+ * @brief Wait until the frame started by `led_strip_refresh_async` is on the wire
+ *
+ * @param strip: LED strip
+ * @param timeout_ms: timeout value, -1 means to wait forever
+ *
+ * @return
+ *      - ESP_OK: The frame has been sent out
+ *      - ESP_ERR_TIMEOUT: The frame is still being sent out when the timeout expires
+ *      - ESP_FAIL: Wait failed because some other error occurred
+ */
+esp_err_t led_strip_wait_refresh_done(led_strip_handle_t strip, int32_t timeout_ms);
+
+/**
+ * @brief Set event callbacks for the LED strip
+ *
+ * @note The callbacks are called from the ISR context, and must be IRAM-safe, see `led_strip_refresh_done_cb_t`
+ *
+ * @param strip: LED strip
+ * @param cbs: group of callback functions
+ * @param user_ctx: user data, which will be passed to the callback functions directly
+ *
+ * @return
+ *      - ESP_OK: Set event callbacks successfully
+ *      - ESP_ERR_INVALID_ARG: Set event callbacks failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Set event callbacks failed because the backend doesn't support it
+ */
+esp_err_t led_strip_register_event_callbacks(led_strip_handle_t strip, const led_strip_event_callbacks_t *cbs, void *user_ctx);
+
+/**
+ * @brief Get the event callbacks registered for the LED strip
+ *
+ * @note Lets a module that registers its own callbacks chain to the ones already there, and put them back when it's done
+ *
+ * @param strip: LED strip
+ * @param ret_cbs: returned group of callback functions, NULL members if none is registered
+ * @param ret_user_ctx: returned user data of the callbacks
+ *
+ * @return
+ *      - ESP_OK: Get event callbacks successfully
+ *      - ESP_ERR_INVALID_ARG: Get event callbacks failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Get event callbacks failed because the backend doesn't support event callbacks
+ */
+esp_err_t led_strip_get_event_callbacks(led_strip_handle_t strip, led_strip_event_callbacks_t *ret_cbs, void **ret_user_ctx);
+
+/**
+ * @brief Clear LED strip (turn off all LEDs)
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Clear LEDs successfully
+ *      - ESP_FAIL: Clear LEDs failed because some other error occurred
+ */
+esp_err_t led_strip_clear(led_strip_handle_t strip);
+
+/**
+ * @brief Set the global brightness of the LED strip
+ *
+ * @note The brightness is applied while the pixels are encoded, the pixel buffer keeps the linear colors.
+ *       So changing the brightness doesn't rewrite any pixel, it takes effect from the next refresh.
+ *       A frame already being sent out by `led_strip_refresh_async` keeps the brightness it started with.
+ *
+ * @param strip: LED strip
+ * @param brightness: brightness scale, 0 - 255, where 255 sends the colors as they are
+ *
+ * @return
+ *      - ESP_OK: Set brightness successfully
+ *      - ESP_ERR_INVALID_ARG: Set brightness failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Set brightness failed because the backend doesn't support it
+ */
+esp_err_t led_strip_set_brightness(led_strip_handle_t strip, uint8_t brightness);
+
+/**
+ * @brief Set the gamma correction table of the LED strip
+ *
+ * @note The table is copied, and applied to every color component before the brightness while the pixels are encoded
+ *       A frame already being sent out by `led_strip_refresh_async` keeps the table it started with.
+ *
+ * @param strip: LED strip
+ * @param gamma_table: table of 256 output values indexed by the linear color value, NULL to disable the gamma correction
+ *
+ * @return
+ *      - ESP_OK: Set gamma table successfully
+ *      - ESP_ERR_INVALID_ARG: Set gamma table failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Set gamma table failed because the backend doesn't support it
+ */
+esp_err_t led_strip_set_gamma_table(led_strip_handle_t strip, const uint8_t *gamma_table);
+
+/**
+ * @brief Report how much memory the LED strip takes in each memory region
+ *
+ * @note Useful to check the effect of `pixel_buf_in_psram` in `led_strip_config_t`
+ *
+ * @param strip: LED strip
+ * @param report: returned memory report
+ *
+ * @return
+ *      - ESP_OK: Get the memory report successfully
+ *      - ESP_ERR_INVALID_ARG: Get the memory report failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Get the memory report failed because the backend doesn't support it
+ */
+esp_err_t led_strip_get_mem_report(led_strip_handle_t strip, led_strip_mem_report_t *report);
+
+/**
+ * @brief Free LED strip resources
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Free resources successfully
+ *      - ESP_FAIL: Free resources failed because error occurred
+ */
+esp_err_t led_strip_del(led_strip_handle_t strip);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Waveform that the capture backend records on refresh
+ */
+typedef enum {
+    LED_STRIP_CAPTURE_WAVEFORM_RMT, /*!< RMT symbols, as the RMT backend would send them */
+    LED_STRIP_CAPTURE_WAVEFORM_SPI, /*!< SPI bytes, as the SPI backend would send them */
+} led_strip_capture_waveform_t;
+
+/**
+ * @brief Captured RMT symbol, laid out the same as `rmt_symbol_word_t`
+ */
+typedef union {
+    struct {
+        uint32_t duration0 : 15; /*!< Duration of level0, in resolution ticks */
+        uint32_t level0 : 1;     /*!< Level of the first part */
+        uint32_t duration1 : 15; /*!< Duration of level1, in resolution ticks */
+        uint32_t level1 : 1;     /*!< Level of the second part */
+    };
+    uint32_t val; /*!< Equivalent unsigned value for the symbol */
+} led_strip_capture_symbol_t;
+
+/**
+ * @brief LED Strip capture specific configuration
+ */
+typedef struct {
+    led_strip_capture_waveform_t waveform; /*!< Waveform to record */
+    uint32_t resolution_hz;                /*!< Tick resolution of the recorded RMT symbols, if set to zero, a default resolution (10MHz) will be applied */
+    led_color_order_t color_order;         /*!< Order in which the color components are sent out. Defaults to GRB */
+} led_strip_capture_config_t;
+
+/**
+ * @brief Create LED strip that records the encoded waveform in memory instead of sending it out
+ *
+ * @note The capture backend doesn't touch any peripheral, so it can be used on the linux target to test and benchmark the pixel handling and encoding
+ *
+ * @param led_config LED strip configuration
+ * @param capture_config capture specific configuration
+ * @param ret_strip Returned LED strip handle
+ * @return
+ *      - ESP_OK: create LED strip handle successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip handle failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create LED strip handle failed because of out of memory
+ */
+esp_err_t led_strip_new_capture_device(const led_strip_config_t *led_config, const led_strip_capture_config_t *capture_config, led_strip_handle_t *ret_strip);
+
+/**
+ * @brief Get the RMT symbols recorded by the last refresh
+ *
+ * @note The last symbol is the reset code
+ *
+ * @param strip: LED strip created by `led_strip_new_capture_device` with `LED_STRIP_CAPTURE_WAVEFORM_RMT`
+ * @param ret_symbols: Returned symbols, valid until the next refresh or the strip is deleted
+ * @param ret_num: Returned number of symbols
+ * @return
+ *      - ESP_OK: Get the symbols successfully
+ *      - ESP_ERR_INVALID_ARG: Get the symbols failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Get the symbols failed because the strip doesn't record RMT symbols
+ */
+esp_err_t led_strip_capture_get_symbols(led_strip_handle_t strip, const led_strip_capture_symbol_t **ret_symbols, size_t *ret_num);
+
+/**
+ * @brief Get the SPI bytes recorded by the last refresh
+ *
+ * @param strip: LED strip created by `led_strip_new_capture_device` with `LED_STRIP_CAPTURE_WAVEFORM_SPI`
+ * @param ret_bytes: Returned SPI bytes, valid until the next refresh or the strip is deleted
+ * @param ret_size: Returned number of bytes
+ * @return
+ *      - ESP_OK: Get the bytes successfully
+ *      - ESP_ERR_INVALID_ARG: Get the bytes failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Get the bytes failed because the strip doesn't record SPI bytes
+ */
+esp_err_t led_strip_capture_get_spi_bytes(led_strip_handle_t strip, const uint8_t **ret_bytes, size_t *ret_size);
+
+/**
+ * @brief Get the number of frames recorded since the strip was created
+ *
+ * @param strip: LED strip created by `led_strip_new_capture_device`
+ * @param ret_count: Returned number of frames
+ * @return
+ *      - ESP_OK: Get the frame count successfully
+ *      - ESP_ERR_INVALID_ARG: Get the frame count failed because of invalid argument
+ */
+esp_err_t led_strip_capture_get_frame_count(led_strip_handle_t strip, uint32_t *ret_count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of layers of a compositor
+ */
+#define LED_STRIP_COMPOSITOR_MAX_LAYERS 8
+
+/**
+ * @brief Pack a color into a compositor pixel
+ */
+#define LED_STRIP_COMPOSITOR_RGB(red, green, blue) \
+    ((((uint32_t)(red) & 0xFF) << 16) | (((uint32_t)(green) & 0xFF) << 8) | ((uint32_t)(blue) & 0xFF))
+
+/**
+ * @brief Pack a color with the white channel into a compositor pixel, for GRBW strips
+ */
+#define LED_STRIP_COMPOSITOR_RGBW(red, green, blue, white) \
+    ((((uint32_t)(white) & 0xFF) << 24) | LED_STRIP_COMPOSITOR_RGB(red, green, blue))
+
+/**
+ * @brief Type of LED strip compositor handle
+ */
+typedef struct led_strip_compositor_t *led_strip_compositor_handle_t;
+
+/**
+ * @brief How a layer is blended onto the layers below it
+ */
+typedef enum {
+    LED_STRIP_BLEND_REPLACE, /*!< The layer covers the layers below it, the opacity only hides the layer when it's zero */
+    LED_STRIP_BLEND_ADD,     /*!< The layer is scaled by its opacity and added, saturating at full brightness. Black pixels leave the layers below unchanged */
+    LED_STRIP_BLEND_ALPHA,   /*!< The layer is mixed with the layers below it by its opacity */
+    LED_STRIP_BLEND_INVALID  /*!< Invalid blend mode */
+} led_strip_blend_mode_t;
+
+/**
+ * @brief LED strip compositor configuration
+ */
+typedef struct {
+    led_strip_handle_t strip;            /*!< LED strip the composed pixels are written to */
+    uint32_t max_leds;                   /*!< Number of pixels of every layer, must not exceed the length of the strip */
+    uint32_t num_layers;                 /*!< Number of layers, up to `LED_STRIP_COMPOSITOR_MAX_LAYERS`. Layer 0 is the bottom one */
+    led_pixel_format_t led_pixel_format; /*!< Pixel format of the strip, the white channel is only written to GRBW strips */
+} led_strip_compositor_config_t;
+
+/**
+ * @brief Create a compositor that blends a stack of layers into a LED strip
+ *
+ * @note The layers start black, in `LED_STRIP_BLEND_REPLACE` mode and with full opacity
+ * @note Like the LED strip itself, the compositor must not be used from several tasks at once
+ *
+ * @param config Compositor configuration
+ * @param ret_compositor Returned compositor handle
+ * @return
+ *      - ESP_OK: Create the compositor successfully
+ *      - ESP_ERR_INVALID_ARG: Create the compositor failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create the compositor failed because of out of memory
+ */
+esp_err_t led_strip_new_compositor(const led_strip_compositor_config_t *config, led_strip_compositor_handle_t *ret_compositor);
+
+/**
+ * @brief Set the blend mode and the opacity of a layer
+ *
+ * @note An opacity of zero hides the layer, 255 is fully opaque
+ *
+ * @param compositor Compositor handle
+ * @param layer Index of the layer
+ * @param mode Blend mode
+ * @param opacity Opacity of the layer (0 - 255)
+ * @return
+ *      - ESP_OK: Set the layer successfully
+ *      - ESP_ERR_INVALID_ARG: Set the layer failed because of invalid argument
+ */
+esp_err_t led_strip_compositor_set_layer(led_strip_compositor_handle_t compositor, uint32_t layer, led_strip_blend_mode_t mode, uint8_t opacity);
+
+/**
+ * @brief Set a range of pixels of a layer
+ *
+ * @param compositor Compositor handle
+ * @param layer Index of the layer
+ * @param start Index of the first pixel to set
+ * @param count Number of pixels to set
+ * @param colors Array of `count` colors, packed with `LED_STRIP_COMPOSITOR_RGB` or `LED_STRIP_COMPOSITOR_RGBW`
+ * @return
+ *      - ESP_OK: Set the pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Set the pixels failed because of invalid argument
+ */
+esp_err_t led_strip_compositor_set_pixels(led_strip_compositor_handle_t compositor, uint32_t layer, uint32_t start, uint32_t count, const uint32_t *colors);
+
+/**
+ * @brief Set the same color for a range of pixels of a layer
+ *
+ * @param compositor Compositor handle
+ * @param layer Index of the layer
+ * @param start Index of the first pixel to set
+ * @param count Number of pixels to set
+ * @param color Color, packed with `LED_STRIP_COMPOSITOR_RGB` or `LED_STRIP_COMPOSITOR_RGBW`
+ * @return
+ *      - ESP_OK: Fill the pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Fill the pixels failed because of invalid argument
+ */
+esp_err_t led_strip_compositor_fill(led_strip_compositor_handle_t compositor, uint32_t layer, uint32_t start, uint32_t count, uint32_t color);
+
+/**
+ * @brief Get the pixels of a layer, so that an effect can draw into it in place
+ *
+ * @note Mark the changed pixels with `led_strip_compositor_mark_dirty`, otherwise they are not blended again
+ *
+ * @param compositor Compositor handle
+ * @param layer Index of the layer
+ * @param ret_pixels Returned array of `max_leds` packed colors
+ * @return
+ *      - ESP_OK: Get the pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Get the pixels failed because of invalid argument
+ */
+esp_err_t led_strip_compositor_get_layer_buffer(led_strip_compositor_handle_t compositor, uint32_t layer, uint32_t **ret_pixels);
+
+/**
+ * @brief Mark a range of pixels of a layer as changed
+ *
+ * @param compositor Compositor handle
+ * @param layer Index of the layer
+ * @param start Index of the first changed pixel
+ * @param count Number of changed pixels
+ * @return
+ *      - ESP_OK: Mark the pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Mark the pixels failed because of invalid argument
+ */
+esp_err_t led_strip_compositor_mark_dirty(led_strip_compositor_handle_t compositor, uint32_t layer, uint32_t start, uint32_t count);
+
+/**
+ * @brief Blend the changed pixels of all the layers and write them into the LED strip
+ *
+ * @note Only the span covering the changed pixels of every layer is blended again and written, the strip still needs a `led_strip_refresh`
+ *
+ * @param compositor Compositor handle
+ * @param ret_changed Returned whether any pixel was written, can be NULL. Fits the return value of a frame engine render callback
+ * @return
+ *      - ESP_OK: Render the layers successfully
+ *      - ESP_ERR_INVALID_ARG: Render the layers failed because of invalid argument
+ *      - ESP_FAIL: Render the layers failed because writing the LED strip failed
+ */
+esp_err_t led_strip_compositor_render(led_strip_compositor_handle_t compositor, bool *ret_changed);
+
+/**
+ * @brief Delete the compositor, the LED strip is left to the caller
+ *
+ * @param compositor Compositor handle
+ * @return
+ *      - ESP_OK: Delete the compositor successfully
+ *      - ESP_ERR_INVALID_ARG: Delete the compositor failed because of invalid argument
+ */
+esp_err_t led_strip_del_compositor(led_strip_compositor_handle_t compositor);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Type of LED strip frame engine handle
+ */
+typedef struct led_strip_frame_engine_t *led_strip_frame_engine_handle_t;
+
+/**
+ * @brief Render callback of the frame engine, called from the engine task once per frame period
+ *
+ * @note The callback should draw the whole frame, in double buffer mode the pixel buffer holds an older frame
+ *
+ * @param strip: LED strip to draw into
+ * @param frame: index of the frame period, which keeps counting when frames are dropped, so animations can be derived from it
+ * @param user_ctx: user data, passed from the engine configuration
+ *
+ * @return Whether the frame has changed and needs to be sent out, returning false skips the refresh
+ */
+typedef bool (*led_strip_frame_render_cb_t)(led_strip_handle_t strip, uint32_t frame, void *user_ctx);
+
+/**
+ * @brief LED strip frame engine configuration
+ */
+typedef struct {
+    led_strip_handle_t strip;              /*!< LED strip to drive. The engine registers its own refresh done callback, which chains to the one registered before, and puts that one back on delete. Don't register callbacks for the strip while the engine exists */
+    uint32_t fps;                          /*!< Target frame rate */
+    led_strip_frame_render_cb_t on_render; /*!< Render callback */
+    void *user_ctx;                        /*!< User data, passed to the render callback */
+    uint32_t task_stack_size;              /*!< Stack size of the engine task, if set to zero, a default size (4096) will be applied */
+    uint32_t task_priority;                /*!< Priority of the engine task, if set to zero, a default priority (5) will be applied */
+} led_strip_frame_engine_config_t;
+
+/**
+ * @brief Frame engine counters, the times are in microseconds
+ */
+typedef struct {
+    uint32_t frames;           /*!< Frames rendered and handed over to the strip */
+    uint32_t skipped;          /*!< Frames that the render callback reported as unchanged */
+    uint32_t dropped;          /*!< Frame periods that passed while the previous frame was still in progress, they are not rendered */
+    uint32_t missed_deadlines; /*!< Frames handed over to the strip after the end of their period */
+    uint32_t render_avg_us;    /*!< Average time of the render callback */
+    uint32_t render_max_us;    /*!< Longest time of the render callback */
+    uint32_t transmit_avg_us;  /*!< Average time from handing a frame over to the strip until it's completely sent out */
+    uint32_t transmit_max_us;  /*!< Longest transmit time */
+    uint32_t jitter_avg_us;    /*!< Average delay of the frame start from the ideal start of its period */
+    uint32_t jitter_max_us;    /*!< Longest delay of the frame start */
+} led_strip_frame_engine_stats_t;
+
+/**
+ * @brief Create a frame engine that renders and sends the frames of a LED strip at a fixed rate
+ *
+ * @note The frames are paced by `esp_timer` rather than the FreeRTOS tick. The frame is handed over with `led_strip_refresh_async`,
+ *       so the next frame is rendered while the previous one is sent out, if the backend supports it (RMT double buffer, SPI frame pipeline).
+ *       Other strips are sent with `led_strip_refresh`
+ *
+ * @param config Engine configuration
+ * @param ret_engine Returned engine handle
+ * @return
+ *      - ESP_OK: Create the engine successfully
+ *      - ESP_ERR_INVALID_ARG: Create the engine failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create the engine failed because of out of memory
+ *      - ESP_FAIL: Create the engine failed because some other error
+ */
+esp_err_t led_strip_new_frame_engine(const led_strip_frame_engine_config_t *config, led_strip_frame_engine_handle_t *ret_engine);
+
+/**
+ * @brief Start rendering frames
+ *
+ * @param engine Engine handle
+ * @return
+ *      - ESP_OK: Start the engine successfully
+ *      - ESP_ERR_INVALID_ARG: Start the engine failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Start the engine failed because it's already running
+ */
+esp_err_t led_strip_frame_engine_start(led_strip_frame_engine_handle_t engine);
+
+/**
+ * @brief Stop rendering frames, the frame in progress is completed
+ *
+ * @param engine Engine handle
+ * @return
+ *      - ESP_OK: Stop the engine successfully
+ *      - ESP_ERR_INVALID_ARG: Stop the engine failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Stop the engine failed because it's not running
+ */
+esp_err_t led_strip_frame_engine_stop(led_strip_frame_engine_handle_t engine);
+
+/**
+ * @brief Get the engine counters
+ *
+ * @param engine Engine handle
+ * @param ret_stats Returned counters
+ * @return
+ *      - ESP_OK: Get the counters successfully
+ *      - ESP_ERR_INVALID_ARG: Get the counters failed because of invalid argument
+ */
+esp_err_t led_strip_frame_engine_get_stats(led_strip_frame_engine_handle_t engine, led_strip_frame_engine_stats_t *ret_stats);
+
+/**
+ * @brief Delete the frame engine, the LED strip is left to the caller
+ *
+ * @param engine Engine handle
+ * @return
+ *      - ESP_OK: Delete the engine successfully
+ *      - ESP_ERR_INVALID_ARG: Delete the engine failed because of invalid argument
+ *      - ESP_FAIL: Delete the engine failed because some other error
+ */
+esp_err_t led_strip_del_frame_engine(led_strip_frame_engine_handle_t engine);
+
+#ifdef __cplusplus
+}
+#endif
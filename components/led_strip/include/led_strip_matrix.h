@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Type of LED matrix handle
+ */
+typedef struct led_strip_matrix_t *led_strip_matrix_handle_t;
+
+/**
+ * @brief How the LEDs of a panel are chained
+ */
+typedef enum {
+    LED_STRIP_MATRIX_ROW_MAJOR,    /*!< The strip runs along the rows, starting from the top left LED */
+    LED_STRIP_MATRIX_COLUMN_MAJOR, /*!< The strip runs along the columns, starting from the top left LED */
+    LED_STRIP_MATRIX_ORDER_INVALID /*!< Invalid order */
+} led_strip_matrix_order_t;
+
+/**
+ * @brief Clockwise rotation of the drawn image on the panel
+ */
+typedef enum {
+    LED_STRIP_MATRIX_ROTATE_0,      /*!< No rotation */
+    LED_STRIP_MATRIX_ROTATE_90,     /*!< Rotate by 90 degrees, the width and the height of the image are swapped */
+    LED_STRIP_MATRIX_ROTATE_180,    /*!< Rotate by 180 degrees */
+    LED_STRIP_MATRIX_ROTATE_270,    /*!< Rotate by 270 degrees, the width and the height of the image are swapped */
+    LED_STRIP_MATRIX_ROTATE_INVALID /*!< Invalid rotation */
+} led_strip_matrix_rotation_t;
+
+/**
+ * @brief LED matrix configuration
+ */
+typedef struct {
+    led_strip_handle_t strip;              /*!< LED strip the panel is made of */
+    uint32_t width;                        /*!< Number of LEDs per row of the panel */
+    uint32_t height;                       /*!< Number of LEDs per column of the panel */
+    uint32_t first_led;                    /*!< Index of the first LED of the panel in the strip, so that several panels can share a strip */
+    led_pixel_format_t led_pixel_format;   /*!< Pixel format of the strip */
+    led_strip_matrix_order_t order;        /*!< How the LEDs are chained */
+    led_strip_matrix_rotation_t rotation;  /*!< Rotation of the drawn image */
+    struct {
+        uint32_t serpentine: 1;            /*!< Every second row (or column) runs backwards */
+        uint32_t flip_x: 1;                /*!< Mirror the drawn image horizontally, applied before the rotation */
+        uint32_t flip_y: 1;                /*!< Mirror the drawn image vertically, applied before the rotation */
+    } flags;                               /*!< Layout flags */
+} led_strip_matrix_config_t;
+
+/**
+ * @brief Create a LED matrix on top of a LED strip
+ *
+ * @note The strip index of every (x, y) is worked out once into a lookup table, so drawing doesn't do any layout math.
+ *       The pixels are written straight into the buffer of the strip (see `led_strip_get_buffer`), and the backends without
+ *       a pixel buffer fall back to `led_strip_set_pixel`
+ * @note The panel must not take more than 65536 LEDs of the strip
+ *
+ * @param config Matrix configuration
+ * @param ret_matrix Returned matrix handle
+ * @return
+ *      - ESP_OK: Create the matrix successfully
+ *      - ESP_ERR_INVALID_ARG: Create the matrix failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create the matrix failed because of out of memory
+ */
+esp_err_t led_strip_new_matrix(const led_strip_matrix_config_t *config, led_strip_matrix_handle_t *ret_matrix);
+
+/**
+ * @brief Get the size of the drawn image, which is the panel size with the rotation applied
+ *
+ * @param matrix Matrix handle
+ * @param ret_width Returned width
+ * @param ret_height Returned height
+ * @return
+ *      - ESP_OK: Get the size successfully
+ *      - ESP_ERR_INVALID_ARG: Get the size failed because of invalid argument
+ */
+esp_err_t led_strip_matrix_get_size(led_strip_matrix_handle_t matrix, uint32_t *ret_width, uint32_t *ret_height);
+
+/**
+ * @brief Get the lookup table of the matrix, for effects that write the strip buffer themselves
+ *
+ * @param matrix Matrix handle
+ * @param ret_table Returned table, the strip index of (x, y) is `table[y * width + x]`
+ * @return
+ *      - ESP_OK: Get the table successfully
+ *      - ESP_ERR_INVALID_ARG: Get the table failed because of invalid argument
+ */
+esp_err_t led_strip_matrix_get_index_table(led_strip_matrix_handle_t matrix, const uint16_t **ret_table);
+
+/**
+ * @brief Set RGB for the pixel at (x, y)
+ *
+ * @param matrix Matrix handle
+ * @param x Column of the pixel
+ * @param y Row of the pixel
+ * @param red Red part of color
+ * @param green Green part of color
+ * @param blue Blue part of color
+ * @return
+ *      - ESP_OK: Set the pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set the pixel failed because of invalid argument
+ *      - ESP_FAIL: Set the pixel failed because other error occurred
+ */
+esp_err_t led_strip_matrix_set_pixel(led_strip_matrix_handle_t matrix, uint32_t x, uint32_t y, uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * @brief Copy a run of pixels into a row
+ *
+ * @param matrix Matrix handle
+ * @param x Column of the first pixel
+ * @param y Row
+ * @param count Number of pixels
+ * @param rgb Packed colors, 3 bytes per pixel in the order of R, G, B
+ * @return
+ *      - ESP_OK: Copy the pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Copy the pixels failed because of invalid argument
+ *      - ESP_FAIL: Copy the pixels failed because other error occurred
+ */
+esp_err_t led_strip_matrix_blit_row(led_strip_matrix_handle_t matrix, uint32_t x, uint32_t y, uint32_t count, const uint8_t *rgb);
+
+/**
+ * @brief Copy an image into a rectangle
+ *
+ * @param matrix Matrix handle
+ * @param x Column of the top left pixel
+ * @param y Row of the top left pixel
+ * @param width Width of the rectangle
+ * @param height Height of the rectangle
+ * @param rgb Packed colors, 3 bytes per pixel in the order of R, G, B, row by row
+ * @param stride Distance between the rows of `rgb` in pixels, if set to zero, `width` will be applied
+ * @return
+ *      - ESP_OK: Copy the image successfully
+ *      - ESP_ERR_INVALID_ARG: Copy the image failed because of invalid argument
+ *      - ESP_FAIL: Copy the image failed because other error occurred
+ */
+esp_err_t led_strip_matrix_blit_rect(led_strip_matrix_handle_t matrix, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                     const uint8_t *rgb, uint32_t stride);
+
+/**
+ * @brief Set the same RGB color for a rectangle
+ *
+ * @param matrix Matrix handle
+ * @param x Column of the top left pixel
+ * @param y Row of the top left pixel
+ * @param width Width of the rectangle
+ * @param height Height of the rectangle
+ * @param red Red part of color
+ * @param green Green part of color
+ * @param blue Blue part of color
+ * @return
+ *      - ESP_OK: Fill the rectangle successfully
+ *      - ESP_ERR_INVALID_ARG: Fill the rectangle failed because of invalid argument
+ *      - ESP_FAIL: Fill the rectangle failed because other error occurred
+ */
+esp_err_t led_strip_matrix_fill_rect(led_strip_matrix_handle_t matrix, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                     uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * @brief Delete the matrix, the LED strip is left to the caller
+ *
+ * @param matrix Matrix handle
+ * @return
+ *      - ESP_OK: Delete the matrix successfully
+ *      - ESP_ERR_INVALID_ARG: Delete the matrix failed because of invalid argument
+ */
+esp_err_t led_strip_del_matrix(led_strip_matrix_handle_t matrix);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+#include "esp_idf_version.h"
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#include "driver/rmt_types.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief LED Strip RMT specific configuration
+ */
+typedef struct {
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+    uint8_t rmt_channel;        /*!< Specify the channel number, the legacy RMT driver doesn't support channel allocator */
+#else // new driver supports specify the clock source and clock resolution
+    rmt_clock_source_t clk_src; /*!< RMT clock source */
+    uint32_t resolution_hz;     /*!< RMT tick resolution, if set to zero, a default resolution (10MHz) will be applied */
+    led_color_order_t color_order; /*!< Order in which the color components are sent out, applied by the encoder. Defaults to GRB */
+#endif
+    size_t mem_block_symbols;   /*!< How many RMT symbols can one RMT channel hold at one time. Set to 0 to size it from `max_leds` (IDF v5 driver only, the legacy driver uses the default size) */
+    struct {
+        uint32_t with_dma: 1;   /*!< Use DMA to transmit data. Chips with RMT DMA have a single DMA capable TX channel, so only one strip can set it. With the IDF v5 driver and `mem_block_symbols` at 0, the DMA buffer is sized from `max_leds` */
+        uint32_t double_buffer: 1; /*!< Allocate a second pixel buffer and keep the RMT channel enabled, so that `led_strip_refresh_async` returns while the frame is sent out. Without it, `led_strip_refresh_async` falls back to a blocking refresh */
+        uint32_t borrow_mem_block: 1; /*!< With `mem_block_symbols` at 0, let a strip that doesn't fit one memory block take the block of the next channel as well, which leaves that channel unusable for other strips (IDF v5 driver only) */
+    } flags;                    /*!< Extra driver flags */
+} led_strip_rmt_config_t;
+
+/**
+ * @brief Create LED strip based on RMT TX channel
+ *
+ * @param led_config LED strip configuration
+ * @param rmt_config RMT specific configuration
+ * @param ret_strip Returned LED strip handle
+ * @return
+ *      - ESP_OK: create LED strip handle successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip handle failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create LED strip handle failed because of out of memory
+ *      - ESP_FAIL: create LED strip handle failed because some other error
+ */
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config, led_strip_handle_t *ret_strip);
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+/**
+ * @brief Type of LED strip group handle, a set of RMT based LED strips that are refreshed at the same time
+ */
+typedef struct led_strip_rmt_group_t *led_strip_rmt_group_handle_t;
+
+/**
+ * @brief RMT channel setup and transmission counters of a LED strip
+ */
+typedef struct {
+    size_t mem_block_symbols;   /*!< RMT memory (or DMA buffer) size of the channel, in symbols */
+    size_t trans_queue_depth;   /*!< Depth of the transaction queue of the channel */
+    bool with_dma;              /*!< Whether the channel sends the data with DMA */
+    uint32_t frames;            /*!< Number of frames sent out since the strip was created */
+    uint32_t last_refills;      /*!< Refill interrupts taken by the last frame */
+    uint32_t max_refills;       /*!< Most refill interrupts taken by a single frame */
+    uint32_t underruns;         /*!< Frames that took longer than their wire time plus half the RMT memory, which is what a late refill looks like */
+    uint32_t deferred;          /*!< Pool strips only: times the strip was left out of `led_strip_rmt_pool_refresh` by the frame budget */
+    uint32_t channel_switches;  /*!< Pool strips only: times a pool channel was routed to the strip */
+    float fps;                  /*!< Frame rate since the previous call of `led_strip_rmt_get_stats` (or since the strip was created) */
+} led_strip_rmt_stats_t;
+
+/**
+ * @brief Get the RMT channel setup and the transmission counters of a LED strip
+ *
+ * @note The underrun count is an estimate from the duration of the frames, a long delay of the transmission done interrupt is counted as well
+ *
+ * @param strip LED strip handle, created by `led_strip_new_rmt_device`
+ * @param ret_stats Returned setup and counters
+ * @return
+ *      - ESP_OK: Get the counters successfully
+ *      - ESP_ERR_INVALID_ARG: Get the counters failed because of invalid argument, e.g. the strip is not RMT based
+ */
+esp_err_t led_strip_rmt_get_stats(led_strip_handle_t strip, led_strip_rmt_stats_t *ret_stats);
+
+/**
+ * @brief Type of LED strip pool handle, a few RMT channels shared by more LED strips
+ */
+typedef struct led_strip_rmt_pool_t *led_strip_rmt_pool_handle_t;
+
+/**
+ * @brief LED Strip RMT pool configuration
+ */
+typedef struct {
+    size_t num_channels;        /*!< Number of RMT TX channels shared by the strips of the pool */
+    rmt_clock_source_t clk_src; /*!< RMT clock source */
+    uint32_t resolution_hz;     /*!< RMT tick resolution, if set to zero, a default resolution (10MHz) will be applied */
+    led_color_order_t color_order; /*!< Order in which the color components are sent out, applied by the encoder. Defaults to GRB */
+    size_t mem_block_symbols;   /*!< How many RMT symbols can one RMT channel hold at one time. Set to 0 will fallback to use the default size */
+    uint32_t frame_budget_us;   /*!< Time that `led_strip_rmt_pool_refresh` may spend, the strips that don't fit are sent first by the next call. 0 for no limit */
+} led_strip_rmt_pool_config_t;
+
+/**
+ * @brief Create a pool of RMT channels, to drive more LED strips than there are RMT TX channels
+ *
+ * @note The channels are created on demand. When a strip is sent through a channel that was last used by another strip,
+ *       the channel is created again on the GPIO of the strip, while the GPIO of the other strip is driven at the idle level
+ *
+ * @param config Pool configuration
+ * @param ret_pool Returned pool handle
+ * @return
+ *      - ESP_OK: create the pool successfully
+ *      - ESP_ERR_INVALID_ARG: create the pool failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create the pool failed because of out of memory
+ */
+esp_err_t led_strip_new_rmt_pool(const led_strip_rmt_pool_config_t *config, led_strip_rmt_pool_handle_t *ret_pool);
+
+/**
+ * @brief Create LED strip that borrows an RMT channel from the pool for each of its frames
+ *
+ * @note `led_strip_refresh` sends the strip alone, `led_strip_rmt_pool_refresh` sends all the strips of the pool
+ *
+ * @param pool Pool handle
+ * @param led_config LED strip configuration
+ * @param ret_strip Returned LED strip handle
+ * @return
+ *      - ESP_OK: create LED strip handle successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip handle failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create LED strip handle failed because of out of memory, or the pool is full (16 strips)
+ *      - ESP_FAIL: create LED strip handle failed because some other error
+ */
+esp_err_t led_strip_new_rmt_pool_device(led_strip_rmt_pool_handle_t pool, const led_strip_config_t *led_config, led_strip_handle_t *ret_strip);
+
+/**
+ * @brief Send all the LED strips of the pool, one strip per channel at a time
+ *
+ * @note The strips are taken in turn, starting from the first one that the previous call left out.
+ *       Once the frame budget can't fit the next round of strips, the remaining strips are deferred to the next call
+ *
+ * @param pool Pool handle
+ * @return
+ *      - ESP_OK: Refresh successfully
+ *      - ESP_ERR_INVALID_ARG: Refresh failed because of invalid argument
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ */
+esp_err_t led_strip_rmt_pool_refresh(led_strip_rmt_pool_handle_t pool);
+
+/**
+ * @brief Delete the pool, its RMT channels are released
+ *
+ * @param pool Pool handle
+ * @return
+ *      - ESP_OK: Delete the pool successfully
+ *      - ESP_ERR_INVALID_ARG: Delete the pool failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Delete the pool failed because some strips of the pool are not deleted yet
+ */
+esp_err_t led_strip_del_rmt_pool(led_strip_rmt_pool_handle_t pool);
+
+/**
+ * @brief Group several RMT based LED strips, so that they start sending out their frames at the same time
+ *
+ * @note The RMT channels are kept enabled and bound to an RMT sync manager, so a grouped strip can only be refreshed through the group
+ * @note Not all the ESP chips support the RMT sync manager, ESP_ERR_NOT_SUPPORTED will be returned on those chips
+ *
+ * @param strips Array of LED strip handles, created by `led_strip_new_rmt_device`
+ * @param num_strips Number of LED strips in the array
+ * @param ret_group Returned LED strip group handle
+ * @return
+ *      - ESP_OK: create LED strip group successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip group failed because of invalid argument, e.g. a strip is not RMT based or already grouped
+ *      - ESP_ERR_NO_MEM: create LED strip group failed because of out of memory
+ *      - ESP_ERR_NOT_SUPPORTED: create LED strip group failed because the chip doesn't support the RMT sync manager
+ *      - ESP_FAIL: create LED strip group failed because some other error
+ */
+esp_err_t led_strip_new_rmt_group(const led_strip_handle_t *strips, size_t num_strips, led_strip_rmt_group_handle_t *ret_group);
+
+/**
+ * @brief Refresh all the LED strips in the group at the same time
+ *
+ * @note All the transmissions start together, and the function waits once for all of them,
+ *       so the time spent equals the time of the longest strip instead of the sum of all the strips
+ *
+ * @param group LED strip group handle
+ * @return
+ *      - ESP_OK: Refresh successfully
+ *      - ESP_ERR_INVALID_ARG: Refresh failed because of invalid argument
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ */
+esp_err_t led_strip_rmt_group_refresh(led_strip_rmt_group_handle_t group);
+
+/**
+ * @brief Delete the LED strip group, the strips are released and can be refreshed separately again
+ *
+ * @param group LED strip group handle
+ * @return
+ *      - ESP_OK: Delete the group successfully
+ *      - ESP_ERR_INVALID_ARG: Delete the group failed because of invalid argument
+ *      - ESP_FAIL: Delete the group failed because some other error occurred
+ */
+esp_err_t led_strip_del_rmt_group(led_strip_rmt_group_handle_t group);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,8 +20,12 @@ extern "C" {
 typedef struct {
     spi_clock_source_t clk_src; /*!< SPI clock source */
     spi_host_device_t spi_bus;  /*!< SPI bus ID. Which buses are available depends on the specific chip */
+    uint8_t num_frame_buffers;  /*!< Number of encoded frame buffers (up to 4) used to pipeline `led_strip_refresh_async`. Set to 0 or 1 for synchronous refresh only, `led_strip_refresh_async` then falls back to a blocking refresh */
+    uint8_t stream_chunks;      /*!< Number of DMA chunks (2 to 4) queued ahead of the wire in streaming mode, if set to zero, a default number (2) will be applied */
+    uint32_t stream_chunk_size; /*!< Color bytes encoded into one DMA chunk in streaming mode, if set to zero, a default size (96) will be applied. Each color byte takes 3 bytes of DMA memory and 9.6us on the wire */
     struct {
         uint32_t with_dma: 1;   /*!< Use DMA to transmit data */
+        uint32_t streaming: 1;  /*!< Keep raw GRB(W) pixels and encode them on the fly into small DMA chunks, instead of keeping the whole encoded frame. Requires `with_dma`. The task calling `led_strip_refresh` refills the chunks, it must get the CPU back within (stream_chunks - 1) chunk times plus the reset time, or the LEDs latch a partial frame */
     } flags;                    /*!< Extra driver flags */
 } led_strip_spi_config_t;
 
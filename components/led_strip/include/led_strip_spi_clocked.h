@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/spi_master.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief LED Strip clocked SPI specific configuration
+ */
+typedef struct {
+    spi_clock_source_t clk_src; /*!< SPI clock source */
+    spi_host_device_t spi_bus;  /*!< SPI bus ID. Which buses are available depends on the specific chip */
+    int clk_gpio_num;           /*!< GPIO number of the clock line, the data line is `strip_gpio_num` of `led_strip_config_t` */
+    uint32_t clock_speed_hz;    /*!< SPI clock frequency, up to 20MHz. If set to zero, a default frequency (10MHz) will be applied */
+    uint8_t global_brightness;  /*!< Initial 5-bit global brightness (0 - 31) sent with every pixel. If set to zero, the full brightness (31) will be applied */
+    struct {
+        uint32_t with_dma: 1;   /*!< Use DMA to transmit data */
+    } flags;                    /*!< Extra driver flags */
+} led_strip_spi_clocked_config_t;
+
+/**
+ * @brief Create LED strip of clocked two-wire LEDs (APA102, SK9822) based on SPI MOSI and SCLK
+ *
+ * @note The pixels are sent as a start frame, a 32-bit frame per pixel (5-bit global brightness, blue, green, red) and an end frame.
+ *       `led_strip_set_brightness` sets the 5-bit global brightness of all the pixels.
+ * @note The clocked LEDs don't have a timing requirement, the whole SPI bus can't be used for other purposes though.
+ *
+ * @param led_config LED strip configuration, `led_model` must be `LED_MODEL_APA102` or `LED_MODEL_SK9822` and `led_pixel_format` must be `LED_PIXEL_FORMAT_GRB`
+ * @param clocked_config clocked SPI specific configuration
+ * @param ret_strip Returned LED strip handle
+ * @return
+ *      - ESP_OK: create LED strip handle successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip handle failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: create LED strip handle failed because of unsupported configuration
+ *      - ESP_ERR_NO_MEM: create LED strip handle failed because of out of memory
+ *      - ESP_FAIL: create LED strip handle failed because some other error
+ */
+esp_err_t led_strip_new_spi_clocked_device(const led_strip_config_t *led_config, const led_strip_spi_clocked_config_t *clocked_config, led_strip_handle_t *ret_strip);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,122 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief LED strip pixel format
+ */
+typedef enum {
+    LED_PIXEL_FORMAT_GRB,    /*!< Pixel format: GRB */
+    LED_PIXEL_FORMAT_GRBW,   /*!< Pixel format: GRBW */
+    LED_PIXEL_FORMAT_INVALID /*!< Invalid pixel format */
+} led_pixel_format_t;
+
+/**
+ * @brief LED strip model
+ * @note Different led model may have different timing parameters, so we need to distinguish them.
+ */
+typedef enum {
+    LED_MODEL_WS2812, /*!< LED strip model: WS2812 */
+    LED_MODEL_SK6812, /*!< LED strip model: SK6812 */
+    LED_MODEL_WS2811, /*!< LED strip model: WS2811, in the high speed mode */
+    LED_MODEL_WS2813, /*!< LED strip model: WS2813 */
+    LED_MODEL_WS2815, /*!< LED strip model: WS2815 */
+    LED_MODEL_APA106, /*!< LED strip model: APA106 */
+    LED_MODEL_APA102, /*!< LED strip model: APA102, clocked two-wire LED, only supported by the clocked SPI backend */
+    LED_MODEL_SK9822, /*!< LED strip model: SK9822, clocked two-wire LED, only supported by the clocked SPI backend */
+    LED_MODEL_INVALID /*!< Invalid LED strip model */
+} led_model_t;
+
+/**
+ * @brief Order in which the color components of a pixel are sent out
+ * @note The pixel buffer always keeps the GRB order, the reordering happens while encoding
+ */
+typedef enum {
+    LED_COLOR_ORDER_GRB, /*!< Send G, R, B (the order of WS2812 and SK6812) */
+    LED_COLOR_ORDER_RGB, /*!< Send R, G, B */
+    LED_COLOR_ORDER_BRG, /*!< Send B, R, G */
+    LED_COLOR_ORDER_RBG, /*!< Send R, B, G */
+    LED_COLOR_ORDER_GBR, /*!< Send G, B, R */
+    LED_COLOR_ORDER_BGR, /*!< Send B, G, R */
+    LED_COLOR_ORDER_INVALID /*!< Invalid color order */
+} led_color_order_t;
+
+/**
+ * @brief HSV color of a pixel
+ */
+typedef struct {
+    uint16_t hue;       /*!< hue part of color (0 - 360) */
+    uint8_t saturation; /*!< saturation part of color (0 - 255) */
+    uint8_t value;      /*!< value part of color (0 - 255) */
+} led_color_hsv_t;
+
+/**
+ * @brief LED strip handle
+ */
+typedef struct led_strip_t *led_strip_handle_t;
+
+/**
+ * @brief Type of LED strip refresh done callback
+ *
+ * @note The callback is called from the ISR context, so it must not block
+ * @note The ISR of the RMT (with `CONFIG_RMT_ISR_IRAM_SAFE`) or SPI (with `CONFIG_SPI_MASTER_ISR_IN_IRAM`, the default) backend can run while
+ *       the flash cache is disabled. The callback must then be placed in IRAM with `IRAM_ATTR`, and only call functions and touch data that are in internal RAM
+ *
+ * @param strip: LED strip whose frame has been completely sent out
+ * @param user_ctx: user data, passed from `led_strip_register_event_callbacks`
+ *
+ * @return Whether a high priority task has been woken up by this function
+ */
+typedef bool (*led_strip_refresh_done_cb_t)(led_strip_handle_t strip, void *user_ctx);
+
+/**
+ * @brief Group of LED strip event callbacks
+ */
+typedef struct {
+    led_strip_refresh_done_cb_t on_refresh_done; /*!< Called when a frame has been completely sent out */
+} led_strip_event_callbacks_t;
+
+/**
+ * @brief LED Strip Configuration
+ */
+typedef struct {
+    int strip_gpio_num;      /*!< GPIO number that used by LED strip */
+    uint32_t max_leds;       /*!< Maximum LEDs in a single strip */
+    led_pixel_format_t led_pixel_format; /*!< LED pixel format */
+    led_model_t led_model;   /*!< LED model */
+    uint32_t reset_us;       /*!< Low time that latches a frame, sent after every refresh, in microseconds.
+                                  Set to 0 to use the default of the LED model (e.g. 280us for WS2812, 300us for WS2813), LEDs that latch earlier can use a shorter one to raise the frame rate */
+    uint8_t *pixel_buf;      /*!< Caller-owned pixel buffer of at least `max_leds` * bytes per pixel, laid out in the pixel format (e.g. GRB).
+                                  The strip draws into and sends out from this memory directly. Set to NULL to let the driver allocate one */
+
+    struct {
+        uint32_t invert_out: 1; /*!< Invert output signal */
+        uint32_t pixel_buf_in_psram: 1; /*!< Allocate the pixel buffer in external RAM (PSRAM), the pixels are copied into small internal buffers while being sent out */
+    } flags;                    /*!< Extra driver flags */
+} led_strip_config_t;
+
+/**
+ * @brief Memory allocated by a LED strip, per memory region
+ *
+ * @note Only the memory allocated by the led_strip itself is counted, a caller-owned pixel buffer or the memory of the peripheral drivers is not
+ */
+typedef struct {
+    size_t internal; /*!< Bytes in internal RAM, including the DMA capable ones */
+    size_t dma;      /*!< Bytes in DMA capable internal RAM */
+    size_t external; /*!< Bytes in external RAM (PSRAM) */
+} led_strip_mem_report_t;
+
+#ifdef __cplusplus
+}
+#endif
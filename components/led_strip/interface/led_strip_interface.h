@@ -0,0 +1,255 @@
+/*
+ * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct led_strip_t led_strip_t; /*!< Type of LED strip */
+
+/**
+ * @brief LED strip interface definition
+ */
+struct led_strip_t {
+    /**
+     * @brief Set RGB for a specific pixel
+     *
+     * @param strip: LED strip
+     * @param index: index of pixel to set
+     * @param red: red part of color
+     * @param green: green part of color
+     * @param blue: blue part of color
+     *
+     * @return
+     *      - ESP_OK: Set RGB for a specific pixel successfully
+     *      - ESP_ERR_INVALID_ARG: Set RGB for a specific pixel failed because of invalid parameters
+     *      - ESP_FAIL: Set RGB for a specific pixel failed because other error occurred
+     */
+    esp_err_t (*set_pixel)(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue);
+
+    /**
+     * @brief Set RGBW for a specific pixel. Similar to `set_pixel` but also set the white component
+     *
+     * @param strip: LED strip
+     * @param index: index of pixel to set
+     * @param red: red part of color
+     * @param green: green part of color
+     * @param blue: blue part of color
+     * @param white: separate white component
+     *
+     * @return
+     *      - ESP_OK: Set RGBW color for a specific pixel successfully
+     *      - ESP_ERR_INVALID_ARG: Set RGBW color for a specific pixel failed because of an invalid argument
+     *      - ESP_FAIL: Set RGBW color for a specific pixel failed because other error occurred
+     */
+    esp_err_t (*set_pixel_rgbw)(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white);
+
+    /**
+     * @brief Set RGB for a range of pixels in one call
+     *
+     * @param strip: LED strip
+     * @param start: index of the first pixel to set
+     * @param count: number of pixels to set
+     * @param rgb: packed colors, 3 bytes per pixel in the order of R, G, B
+     *
+     * @return
+     *      - ESP_OK: Set RGB for the pixel range successfully
+     *      - ESP_ERR_INVALID_ARG: Set RGB for the pixel range failed because the range exceeds the strip length
+     *      - ESP_FAIL: Set RGB for the pixel range failed because other error occurred
+     */
+    esp_err_t (*set_pixels)(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb);
+
+    /**
+     * @brief Set the same RGB color for a range of pixels
+     *
+     * @param strip: LED strip
+     * @param start: index of the first pixel to set
+     * @param count: number of pixels to set
+     * @param red: red part of color
+     * @param green: green part of color
+     * @param blue: blue part of color
+     *
+     * @return
+     *      - ESP_OK: Fill the pixel range successfully
+     *      - ESP_ERR_INVALID_ARG: Fill the pixel range failed because the range exceeds the strip length
+     *      - ESP_FAIL: Fill the pixel range failed because other error occurred
+     */
+    esp_err_t (*fill)(led_strip_t *strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue);
+
+    /**
+     * @brief Copy a whole frame, already laid out in the strip's pixel format, into the strip
+     *
+     * @param strip: LED strip
+     * @param frame: frame data, e.g. G, R, B (, W) bytes per pixel, starting from pixel 0
+     * @param size: size of the frame in bytes, must be a multiple of the bytes per pixel
+     *
+     * @return
+     *      - ESP_OK: Write the frame successfully
+     *      - ESP_ERR_INVALID_ARG: Write the frame failed because the size is invalid
+     *      - ESP_FAIL: Write the frame failed because other error occurred
+     */
+    esp_err_t (*write_frame)(led_strip_t *strip, const uint8_t *frame, size_t size);
+
+    /**
+     * @brief Get the pixel buffer that the strip sends out from
+     *
+     * @param strip: LED strip
+     * @param ret_buf: returned pixel buffer, laid out in the pixel format of the strip
+     * @param ret_size: returned size of the pixel buffer in bytes
+     *
+     * @return
+     *      - ESP_OK: Get the pixel buffer successfully
+     *      - ESP_ERR_NOT_SUPPORTED: Get the pixel buffer failed because the backend doesn't keep the pixels in the pixel format
+     */
+    esp_err_t (*get_buffer)(led_strip_t *strip, uint8_t **ret_buf, size_t *ret_size);
+
+    /**
+     * @brief Set the number of leading pixels that are sent out by the following refreshes
+     *
+     * @param strip: LED strip
+     * @param length: number of pixels to send, from 1 to the maximum number of LEDs
+     *
+     * @return
+     *      - ESP_OK: Set the active length successfully
+     *      - ESP_ERR_INVALID_ARG: Set the active length failed because the length is out of range
+     *      - ESP_FAIL: Set the active length failed because other error occurred
+     */
+    esp_err_t (*set_active_length)(led_strip_t *strip, uint32_t length);
+
+    /**
+     * @brief Refresh memory colors to LEDs
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: timeout value for refreshing task
+     *
+     * @return
+     *      - ESP_OK: Refresh successfully
+     *      - ESP_FAIL: Refresh failed because some other error occurred
+     *
+     * @note:
+     *      After updating the LED colors in the memory, a following invocation of this API is needed to flush colors to strip.
+     */
+    esp_err_t (*refresh)(led_strip_t *strip);
+
+    /**
+     * @brief Start sending the drawn frame to LEDs without waiting for it to finish
+     *
+     * @param strip: LED strip
+     *
+     * @return
+     *      - ESP_OK: Start the refresh successfully
+     *      - ESP_ERR_INVALID_STATE: Start the refresh failed because the strip is not configured for asynchronous refresh
+     *      - ESP_FAIL: Start the refresh failed because some other error occurred
+     */
+    esp_err_t (*refresh_async)(led_strip_t *strip);
+
+    /**
+     * @brief Wait for the pending asynchronous refresh to finish
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: timeout value, -1 means to wait forever
+     *
+     * @return
+     *      - ESP_OK: The frame has been sent out
+     *      - ESP_ERR_TIMEOUT: The frame is still being sent out when the timeout expires
+     *      - ESP_FAIL: Wait failed because some other error occurred
+     */
+    esp_err_t (*wait_refresh_done)(led_strip_t *strip, int32_t timeout_ms);
+
+    /**
+     * @brief Set event callbacks for the LED strip
+     *
+     * @param strip: LED strip
+     * @param cbs: group of callback functions
+     * @param user_ctx: user data, which will be passed to the callback functions directly
+     *
+     * @return
+     *      - ESP_OK: Set event callbacks successfully
+     *      - ESP_FAIL: Set event callbacks failed because some other error occurred
+     */
+    esp_err_t (*register_event_callbacks)(led_strip_t *strip, const led_strip_event_callbacks_t *cbs, void *user_ctx);
+
+    /**
+     * @brief Get the event callbacks registered for the LED strip
+     *
+     * @param strip: LED strip
+     * @param ret_cbs: returned group of callback functions, NULL members if none is registered
+     * @param ret_user_ctx: returned user data of the callbacks
+     *
+     * @return
+     *      - ESP_OK: Get event callbacks successfully
+     *      - ESP_FAIL: Get event callbacks failed because some other error occurred
+     */
+    esp_err_t (*get_event_callbacks)(led_strip_t *strip, led_strip_event_callbacks_t *ret_cbs, void **ret_user_ctx);
+
+    /**
+     * @brief Clear LED strip (turn off all LEDs)
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: timeout value for clearing task
+     *
+     * @return
+     *      - ESP_OK: Clear LEDs successfully
+     *      - ESP_FAIL: Clear LEDs failed because some other error occurred
+     */
+    esp_err_t (*clear)(led_strip_t *strip);
+
+    /**
+     * @brief Set the global brightness applied while the pixels are sent out
+     *
+     * @param strip: LED strip
+     * @param brightness: brightness scale, 255 means the pixel buffer is sent as is
+     *
+     * @return
+     *      - ESP_OK: Set brightness successfully
+     *      - ESP_FAIL: Set brightness failed because some other error occurred
+     */
+    esp_err_t (*set_brightness)(led_strip_t *strip, uint8_t brightness);
+
+    /**
+     * @brief Set the gamma table applied to every color component while the pixels are sent out
+     *
+     * @param strip: LED strip
+     * @param gamma_table: table of 256 output values, NULL to disable the gamma correction
+     *
+     * @return
+     *      - ESP_OK: Set gamma table successfully
+     *      - ESP_FAIL: Set gamma table failed because some other error occurred
+     */
+    esp_err_t (*set_gamma_table)(led_strip_t *strip, const uint8_t *gamma_table);
+
+    /**
+     * @brief Report the memory allocated by the LED strip, per memory region
+     *
+     * @param strip: LED strip
+     * @param report: returned memory report
+     *
+     * @return
+     *      - ESP_OK: Get the memory report successfully
+     *      - ESP_FAIL: Get the memory report failed because some other error occurred
+     */
+    esp_err_t (*get_mem_report)(led_strip_t *strip, led_strip_mem_report_t *report);
+
+    /**
+     * @brief Free LED strip resources
+     *
+     * @param strip: LED strip
+     *
+     * @return
+     *      - ESP_OK: Free resources successfully
+     *      - ESP_FAIL: Free resources failed because error occurred
+     */
+    esp_err_t (*del)(led_strip_t *strip);
+};
+
+#ifdef __cplusplus
+}
+#endif
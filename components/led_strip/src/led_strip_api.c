@@ -0,0 +1,199 @@
+/*
+ * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+
+static const char *TAG = "led_strip";
+
+esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->set_pixel(strip, index, red, green, blue);
+}
+
+// number of pixels converted on the stack before they are written to the strip in one go
+#define LED_STRIP_HSV_BATCH_PIXELS 32
+
+// components of each 60 degree hue sector, as indexes into {max, min, rising, falling}
+static const uint8_t s_hsv_sector_map[6][3] = {
+    {0, 2, 1}, // red = max, green rising, blue = min
+    {3, 0, 1}, // red falling, green = max, blue = min
+    {1, 0, 2}, // red = min, green = max, blue rising
+    {1, 3, 0}, // red = min, green falling, blue = max
+    {2, 1, 0}, // red rising, green = min, blue = max
+    {0, 1, 3}, // red = max, green = min, blue falling
+};
+
+static inline void led_strip_hsv2rgb(uint16_t hue, uint8_t saturation, uint8_t value, uint8_t *rgb)
+{
+    // x / 255 for x <= 255 * 255, without a division
+    uint32_t x = (uint32_t)value * (255 - saturation);
+    uint32_t rgb_min = (x + 1 + (x >> 8)) >> 8;
+    // x / 60 is computed as (x * 34953) >> 21, which is exact for any 16-bit x
+    uint32_t sector = ((uint32_t)hue * 34953) >> 21;
+    uint32_t diff = hue - sector * 60;
+    // RGB adjustment amount by hue
+    uint32_t rgb_adj = ((value - rgb_min) * diff * 34953) >> 21;
+
+    uint8_t levels[4] = {value, rgb_min, rgb_min + rgb_adj, value - rgb_adj};
+    const uint8_t *map = s_hsv_sector_map[sector < 5 ? sector : 5];
+    rgb[0] = levels[map[0]];
+    rgb[1] = levels[map[1]];
+    rgb[2] = levels[map[2]];
+}
+
+esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint16_t hue, uint8_t saturation, uint8_t value)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    uint8_t rgb[3];
+    led_strip_hsv2rgb(hue, saturation, value, rgb);
+    return strip->set_pixel(strip, index, rgb[0], rgb[1], rgb[2]);
+}
+
+esp_err_t led_strip_set_pixels_hsv(led_strip_handle_t strip, uint32_t start, uint32_t count, const led_color_hsv_t *hsv)
+{
+    ESP_RETURN_ON_FALSE(strip && (hsv || count == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    uint8_t rgb[LED_STRIP_HSV_BATCH_PIXELS * 3];
+    while (count) {
+        uint32_t batch = count < LED_STRIP_HSV_BATCH_PIXELS ? count : LED_STRIP_HSV_BATCH_PIXELS;
+        for (uint32_t i = 0; i < batch; i++) {
+            led_strip_hsv2rgb(hsv[i].hue, hsv[i].saturation, hsv[i].value, &rgb[i * 3]);
+        }
+        ESP_RETURN_ON_ERROR(led_strip_set_pixels(strip, start, batch, rgb), TAG, "set pixels failed");
+        start += batch;
+        count -= batch;
+        hsv += batch;
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_set_pixel_rgbw(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->set_pixel_rgbw(strip, index, red, green, blue, white);
+}
+
+esp_err_t led_strip_set_pixels(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    ESP_RETURN_ON_FALSE(strip && (rgb || count == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->set_pixels) {
+        return strip->set_pixels(strip, start, count, rgb);
+    }
+    // fall back to the per-pixel path for backends that don't implement the bulk write
+    for (uint32_t i = 0; i < count; i++, rgb += 3) {
+        ESP_RETURN_ON_ERROR(strip->set_pixel(strip, start + i, rgb[0], rgb[1], rgb[2]), TAG, "set pixel failed");
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_fill(led_strip_handle_t strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->fill) {
+        return strip->fill(strip, start, count, red, green, blue);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        ESP_RETURN_ON_ERROR(strip->set_pixel(strip, start + i, red, green, blue), TAG, "set pixel failed");
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_write_frame(led_strip_handle_t strip, const uint8_t *frame, size_t size)
+{
+    ESP_RETURN_ON_FALSE(strip && (frame || size == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->write_frame, ESP_ERR_NOT_SUPPORTED, TAG, "write frame not supported");
+    return strip->write_frame(strip, frame, size);
+}
+
+esp_err_t led_strip_get_buffer(led_strip_handle_t strip, uint8_t **ret_buf, size_t *ret_size)
+{
+    ESP_RETURN_ON_FALSE(strip && ret_buf && ret_size, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->get_buffer, ESP_ERR_NOT_SUPPORTED, TAG, "get buffer not supported");
+    return strip->get_buffer(strip, ret_buf, ret_size);
+}
+
+esp_err_t led_strip_set_active_length(led_strip_handle_t strip, uint32_t length)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->set_active_length, ESP_ERR_NOT_SUPPORTED, TAG, "active length not supported");
+    return strip->set_active_length(strip, length);
+}
+
+esp_err_t led_strip_refresh(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->refresh(strip);
+}
+
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->refresh_async) {
+        return strip->refresh_async(strip);
+    }
+    return strip->refresh(strip);
+}
+
+esp_err_t led_strip_wait_refresh_done(led_strip_handle_t strip, int32_t timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->wait_refresh_done) {
+        return strip->wait_refresh_done(strip, timeout_ms);
+    }
+    // the synchronous refresh has already finished
+    return ESP_OK;
+}
+
+esp_err_t led_strip_register_event_callbacks(led_strip_handle_t strip, const led_strip_event_callbacks_t *cbs, void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(strip && cbs, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->register_event_callbacks, ESP_ERR_NOT_SUPPORTED, TAG, "event callbacks not supported");
+    return strip->register_event_callbacks(strip, cbs, user_ctx);
+}
+
+esp_err_t led_strip_get_event_callbacks(led_strip_handle_t strip, led_strip_event_callbacks_t *ret_cbs, void **ret_user_ctx)
+{
+    ESP_RETURN_ON_FALSE(strip && ret_cbs && ret_user_ctx, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->get_event_callbacks, ESP_ERR_NOT_SUPPORTED, TAG, "event callbacks not supported");
+    return strip->get_event_callbacks(strip, ret_cbs, ret_user_ctx);
+}
+
+esp_err_t led_strip_clear(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->clear(strip);
+}
+
+esp_err_t led_strip_set_brightness(led_strip_handle_t strip, uint8_t brightness)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->set_brightness, ESP_ERR_NOT_SUPPORTED, TAG, "brightness not supported");
+    return strip->set_brightness(strip, brightness);
+}
+
+esp_err_t led_strip_set_gamma_table(led_strip_handle_t strip, const uint8_t *gamma_table)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->set_gamma_table, ESP_ERR_NOT_SUPPORTED, TAG, "gamma correction not supported");
+    return strip->set_gamma_table(strip, gamma_table);
+}
+
+esp_err_t led_strip_get_mem_report(led_strip_handle_t strip, led_strip_mem_report_t *report)
+{
+    ESP_RETURN_ON_FALSE(strip && report, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->get_mem_report, ESP_ERR_NOT_SUPPORTED, TAG, "memory report not supported");
+    memset(report, 0, sizeof(led_strip_mem_report_t));
+    return strip->get_mem_report(strip, report);
+}
+
+esp_err_t led_strip_del(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->del(strip);
+}
@@ -0,0 +1,312 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_spi_encoder.h"
+#include "led_strip_timing.h"
+#include "led_strip_encoding.h"
+
+#define LED_STRIP_CAPTURE_DEFAULT_RESOLUTION (10 * 1000 * 1000) // 10MHz resolution
+
+static const char *TAG = "led_strip_capture";
+
+typedef struct {
+    led_strip_t base;
+    led_strip_capture_waveform_t waveform;
+    uint32_t strip_len;
+    uint32_t active_len;   // number of leading pixels sent by a refresh
+    uint32_t sent_len;     // number of pixels sent by the last frame, the ones beyond the active length need to be blanked once
+    uint8_t bytes_per_pixel;
+    led_strip_transform_t transform; // color order, gamma correction and brightness, shared with the RMT encoder
+    uint32_t nibble_symbols[16][4]; // symbols of every 4-bit value (MSB first)
+    led_strip_capture_symbol_t reset_code;
+    uint32_t frame_count;
+    size_t waveform_size;  // number of symbols or SPI bytes recorded by the last refresh
+    void *waveform_buf;    // recorded symbols or SPI bytes
+    uint8_t *pixel_buf;    // either the caller-owned pixel buffer or the storage below
+    uint8_t storage[0];
+} led_strip_capture_obj;
+
+static esp_err_t led_strip_capture_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    ESP_RETURN_ON_FALSE(index < capture_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    uint32_t start = index * capture_strip->bytes_per_pixel;
+    // In thr order of GRB, as LED strip like WS2812 sends out pixels in this order
+    capture_strip->pixel_buf[start + 0] = green & 0xFF;
+    capture_strip->pixel_buf[start + 1] = red & 0xFF;
+    capture_strip->pixel_buf[start + 2] = blue & 0xFF;
+    if (capture_strip->bytes_per_pixel > 3) {
+        capture_strip->pixel_buf[start + 3] = 0;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    ESP_RETURN_ON_FALSE(index < capture_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(capture_strip->bytes_per_pixel == 4, ESP_ERR_INVALID_ARG, TAG, "wrong LED pixel format, expected 4 bytes per pixel");
+    uint8_t *buf_start = capture_strip->pixel_buf + index * 4;
+    // SK6812 component order is GRBW
+    *buf_start = green & 0xFF;
+    *++buf_start = red & 0xFF;
+    *++buf_start = blue & 0xFF;
+    *++buf_start = white & 0xFF;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    ESP_RETURN_ON_FALSE(start <= capture_strip->strip_len && count <= capture_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint8_t bytes_per_pixel = capture_strip->bytes_per_pixel;
+    uint8_t *buf = capture_strip->pixel_buf + start * bytes_per_pixel;
+    for (uint32_t i = 0; i < count; i++) {
+        // In the order of GRB
+        buf[0] = rgb[1];
+        buf[1] = rgb[0];
+        buf[2] = rgb[2];
+        if (bytes_per_pixel > 3) {
+            buf[3] = 0;
+        }
+        buf += bytes_per_pixel;
+        rgb += 3;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_fill(led_strip_t *strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    ESP_RETURN_ON_FALSE(start <= capture_strip->strip_len && count <= capture_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint8_t bytes_per_pixel = capture_strip->bytes_per_pixel;
+    const uint8_t pixel[4] = {green & 0xFF, red & 0xFF, blue & 0xFF, 0};
+    uint8_t *buf = capture_strip->pixel_buf + start * bytes_per_pixel;
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(buf, pixel, bytes_per_pixel);
+        buf += bytes_per_pixel;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_write_frame(led_strip_t *strip, const uint8_t *frame, size_t size)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    ESP_RETURN_ON_FALSE(size % capture_strip->bytes_per_pixel == 0 && size <= capture_strip->strip_len * capture_strip->bytes_per_pixel, ESP_ERR_INVALID_ARG, TAG,
+                        "frame size doesn't fit the LED strip");
+    memcpy(capture_strip->pixel_buf, frame, size);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_get_buffer(led_strip_t *strip, uint8_t **ret_buf, size_t *ret_size)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    *ret_buf = capture_strip->pixel_buf;
+    *ret_size = capture_strip->strip_len * capture_strip->bytes_per_pixel;
+    return ESP_OK;
+}
+
+// emit the waveform of one color byte, returns the position after it
+static inline void *led_strip_capture_encode_byte(led_strip_capture_obj *capture_strip, uint8_t data, void *out)
+{
+    if (capture_strip->waveform == LED_STRIP_CAPTURE_WAVEFORM_SPI) {
+        led_strip_spi_encode_byte(data, out);
+        return (uint8_t *)out + SPI_BYTES_PER_COLOR_BYTE;
+    }
+    // one byte takes two table lookups, high nibble first
+    led_strip_encode_byte_symbols(capture_strip->nibble_symbols, data, out);
+    return (uint32_t *)out + 8;
+}
+
+static esp_err_t led_strip_capture_set_active_length(led_strip_t *strip, uint32_t length)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    ESP_RETURN_ON_FALSE(length && length <= capture_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "active length out of maximum number of LEDs");
+    capture_strip->active_len = length;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_refresh(led_strip_t *strip)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    uint8_t bytes_per_pixel = capture_strip->bytes_per_pixel;
+    size_t active_size = capture_strip->active_len * bytes_per_pixel;
+    // the pixels that the last frame lit beyond the active length are sent as zeros, the pixel buffer stays untouched
+    uint32_t len = capture_strip->sent_len > capture_strip->active_len ? capture_strip->sent_len : capture_strip->active_len;
+    size_t size = len * bytes_per_pixel;
+    void *out = capture_strip->waveform_buf;
+    if (!capture_strip->transform.active) {
+        if (capture_strip->waveform == LED_STRIP_CAPTURE_WAVEFORM_SPI) {
+            led_strip_spi_encode(capture_strip->pixel_buf, active_size, out);
+            out = (uint8_t *)out + active_size * SPI_BYTES_PER_COLOR_BYTE;
+        } else {
+            for (size_t i = 0; i < active_size; i++) {
+                out = led_strip_capture_encode_byte(capture_strip, capture_strip->pixel_buf[i], out);
+            }
+        }
+    } else {
+        // transform the pixels one by one, the same as the RMT encoder does
+        uint8_t pixel[4];
+        for (uint32_t i = 0; i < capture_strip->active_len; i++) {
+            led_strip_transform_pixel(&capture_strip->transform, capture_strip->pixel_buf + i * bytes_per_pixel, pixel, bytes_per_pixel);
+            for (int j = 0; j < bytes_per_pixel; j++) {
+                out = led_strip_capture_encode_byte(capture_strip, pixel[j], out);
+            }
+        }
+    }
+    for (size_t i = active_size; i < size; i++) {
+        out = led_strip_capture_encode_byte(capture_strip, 0, out);
+    }
+    capture_strip->sent_len = capture_strip->active_len;
+    if (capture_strip->waveform == LED_STRIP_CAPTURE_WAVEFORM_RMT) {
+        // 8 symbols per color byte, plus the reset code
+        *(led_strip_capture_symbol_t *)out = capture_strip->reset_code;
+        capture_strip->waveform_size = size * 8 + 1;
+    } else {
+        capture_strip->waveform_size = size * SPI_BYTES_PER_COLOR_BYTE;
+    }
+    capture_strip->frame_count++;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_clear(led_strip_t *strip)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    // Write zero to turn off all leds
+    memset(capture_strip->pixel_buf, 0, capture_strip->strip_len * capture_strip->bytes_per_pixel);
+    return led_strip_capture_refresh(strip);
+}
+
+static esp_err_t led_strip_capture_set_brightness(led_strip_t *strip, uint8_t brightness)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    led_strip_transform_set_brightness(&capture_strip->transform, brightness);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_set_gamma_table(led_strip_t *strip, const uint8_t *gamma_table)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    led_strip_transform_set_gamma_table(&capture_strip->transform, gamma_table);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_capture_del(led_strip_t *strip)
+{
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    free(capture_strip->waveform_buf);
+    free(capture_strip);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_capture_device(const led_strip_config_t *led_config, const led_strip_capture_config_t *capture_config, led_strip_handle_t *ret_strip)
+{
+    led_strip_capture_obj *capture_strip = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config && capture_config && ret_strip, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(led_config->led_pixel_format < LED_PIXEL_FORMAT_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led_pixel_format");
+    ESP_GOTO_ON_FALSE(led_strip_get_timing(led_config->led_model), ESP_ERR_INVALID_ARG, err, TAG, "invalid led_model");
+    ESP_GOTO_ON_FALSE(capture_config->waveform <= LED_STRIP_CAPTURE_WAVEFORM_SPI, ESP_ERR_INVALID_ARG, err, TAG, "invalid waveform");
+    ESP_GOTO_ON_FALSE(capture_config->color_order < LED_COLOR_ORDER_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid color_order");
+    uint8_t bytes_per_pixel = 3;
+    if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRBW) {
+        bytes_per_pixel = 4;
+    } else if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRB) {
+        bytes_per_pixel = 3;
+    } else {
+        assert(false);
+    }
+    size_t storage_size = led_config->pixel_buf ? 0 : led_config->max_leds * bytes_per_pixel;
+    capture_strip = calloc(1, sizeof(led_strip_capture_obj) + storage_size);
+    ESP_GOTO_ON_FALSE(capture_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for capture strip");
+    capture_strip->pixel_buf = led_config->pixel_buf ? led_config->pixel_buf : capture_strip->storage;
+
+    size_t waveform_size = 0;
+    if (capture_config->waveform == LED_STRIP_CAPTURE_WAVEFORM_RMT) {
+        waveform_size = (led_config->max_leds * bytes_per_pixel * 8 + 1) * sizeof(led_strip_capture_symbol_t);
+    } else {
+        waveform_size = led_config->max_leds * bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    }
+    capture_strip->waveform_buf = calloc(1, waveform_size);
+    ESP_GOTO_ON_FALSE(capture_strip->waveform_buf, ESP_ERR_NO_MEM, err, TAG, "no mem for captured waveform");
+
+    uint32_t resolution = capture_config->resolution_hz ? capture_config->resolution_hz : LED_STRIP_CAPTURE_DEFAULT_RESOLUTION;
+    // same symbols and transform as the RMT encoder
+    const led_strip_timing_t *timing = led_strip_get_timing(led_config->led_model);
+    uint32_t bit0 = 0;
+    uint32_t bit1 = 0;
+    led_strip_get_bit_symbols(timing, resolution, &bit0, &bit1);
+    led_strip_build_nibble_symbols(bit0, bit1, capture_strip->nibble_symbols);
+    uint32_t reset_us = led_config->reset_us ? led_config->reset_us : timing->reset_us;
+    ESP_GOTO_ON_ERROR(led_strip_get_reset_symbol(reset_us, resolution, &capture_strip->reset_code.val), err, TAG, "invalid reset time");
+    led_strip_transform_init(&capture_strip->transform, capture_config->color_order);
+
+    capture_strip->waveform = capture_config->waveform;
+    capture_strip->bytes_per_pixel = bytes_per_pixel;
+    capture_strip->strip_len = led_config->max_leds;
+    capture_strip->active_len = led_config->max_leds;
+    capture_strip->sent_len = led_config->max_leds;
+    capture_strip->base.set_pixel = led_strip_capture_set_pixel;
+    capture_strip->base.set_pixel_rgbw = led_strip_capture_set_pixel_rgbw;
+    capture_strip->base.set_pixels = led_strip_capture_set_pixels;
+    capture_strip->base.fill = led_strip_capture_fill;
+    capture_strip->base.write_frame = led_strip_capture_write_frame;
+    capture_strip->base.get_buffer = led_strip_capture_get_buffer;
+    capture_strip->base.set_active_length = led_strip_capture_set_active_length;
+    capture_strip->base.refresh = led_strip_capture_refresh;
+    capture_strip->base.clear = led_strip_capture_clear;
+    capture_strip->base.set_brightness = led_strip_capture_set_brightness;
+    capture_strip->base.set_gamma_table = led_strip_capture_set_gamma_table;
+    capture_strip->base.del = led_strip_capture_del;
+
+    *ret_strip = &capture_strip->base;
+    return ESP_OK;
+err:
+    if (capture_strip) {
+        if (capture_strip->waveform_buf) {
+            free(capture_strip->waveform_buf);
+        }
+        free(capture_strip);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_capture_get_symbols(led_strip_handle_t strip, const led_strip_capture_symbol_t **ret_symbols, size_t *ret_num)
+{
+    ESP_RETURN_ON_FALSE(strip && ret_symbols && ret_num, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->del == led_strip_capture_del, ESP_ERR_INVALID_ARG, TAG, "not a capture strip");
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    ESP_RETURN_ON_FALSE(capture_strip->waveform == LED_STRIP_CAPTURE_WAVEFORM_RMT, ESP_ERR_INVALID_STATE, TAG, "strip doesn't record RMT symbols");
+    *ret_symbols = capture_strip->waveform_buf;
+    *ret_num = capture_strip->waveform_size;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_capture_get_spi_bytes(led_strip_handle_t strip, const uint8_t **ret_bytes, size_t *ret_size)
+{
+    ESP_RETURN_ON_FALSE(strip && ret_bytes && ret_size, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->del == led_strip_capture_del, ESP_ERR_INVALID_ARG, TAG, "not a capture strip");
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    ESP_RETURN_ON_FALSE(capture_strip->waveform == LED_STRIP_CAPTURE_WAVEFORM_SPI, ESP_ERR_INVALID_STATE, TAG, "strip doesn't record SPI bytes");
+    *ret_bytes = capture_strip->waveform_buf;
+    *ret_size = capture_strip->waveform_size;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_capture_get_frame_count(led_strip_handle_t strip, uint32_t *ret_count)
+{
+    ESP_RETURN_ON_FALSE(strip && ret_count, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->del == led_strip_capture_del, ESP_ERR_INVALID_ARG, TAG, "not a capture strip");
+    led_strip_capture_obj *capture_strip = __containerof(strip, led_strip_capture_obj, base);
+    *ret_count = capture_strip->frame_count;
+    return ESP_OK;
+}
@@ -0,0 +1,267 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "led_strip.h"
+#include "led_strip_compositor.h"
+
+// pixels converted on the stack per led_strip_set_pixels call
+#define LED_STRIP_COMPOSITOR_BATCH_PIXELS 32
+
+// the packed pixel split into two words of 8-bit channels in 16-bit lanes: (W, G) and (R, B)
+#define LANE_MASK 0x00FF00FF
+
+static const char *TAG = "led_strip_compositor";
+
+typedef struct {
+    uint32_t *pixels;
+    led_strip_blend_mode_t mode;
+    uint8_t opacity;
+    uint32_t dirty_start; // changed pixels since the last render, empty when dirty_start >= dirty_end
+    uint32_t dirty_end;
+} led_strip_layer_t;
+
+typedef struct led_strip_compositor_t {
+    led_strip_handle_t strip;
+    uint32_t max_leds;
+    uint32_t num_layers;
+    bool with_white;
+    uint32_t *out; // composed pixels, kept between renders so that only the changed span is blended again
+    led_strip_layer_t layers[];
+} led_strip_compositor_t;
+
+// scale all four channels by weight (0 - 256), two channels per multiplication
+static inline uint32_t led_strip_swar_scale(uint32_t color, uint32_t weight)
+{
+    uint32_t rb = (((color & LANE_MASK) * weight) >> 8) & LANE_MASK;
+    uint32_t wg = (((color >> 8) & LANE_MASK) * weight) & ~LANE_MASK;
+    return rb | wg;
+}
+
+// per channel dst + (src - dst) * weight / 256, every lane stays below 16 bits: 255 * weight + 255 * (256 - weight)
+static inline uint32_t led_strip_swar_mix(uint32_t dst, uint32_t src, uint32_t weight)
+{
+    uint32_t inv = 256 - weight;
+    uint32_t rb = (((src & LANE_MASK) * weight + (dst & LANE_MASK) * inv) >> 8) & LANE_MASK;
+    uint32_t wg = (((src >> 8) & LANE_MASK) * weight + ((dst >> 8) & LANE_MASK) * inv) & ~LANE_MASK;
+    return rb | wg;
+}
+
+// per channel saturating add, the low 7 bits are added in parallel and the carry out of every byte turns into 0xFF
+static inline uint32_t led_strip_swar_add(uint32_t a, uint32_t b)
+{
+    uint32_t sum = (a & 0x7F7F7F7F) + (b & 0x7F7F7F7F);
+    uint32_t carry = ((a & b) | ((a | b) & sum)) & 0x80808080;
+    sum ^= (a ^ b) & 0x80808080;
+    return sum | ((carry >> 7) * 0xFF);
+}
+
+static void led_strip_compositor_blend_span(uint32_t *restrict out, const uint32_t *restrict src, uint32_t count,
+                                            led_strip_blend_mode_t mode, uint8_t opacity)
+{
+    // map 255 to 256, so that a fully opaque layer gives back its own colors
+    uint32_t weight = opacity + (opacity >> 7);
+    switch (mode) {
+    case LED_STRIP_BLEND_REPLACE:
+        memcpy(out, src, count * sizeof(uint32_t));
+        break;
+    case LED_STRIP_BLEND_ADD:
+        if (weight == 256) {
+            for (uint32_t i = 0; i < count; i++) {
+                out[i] = led_strip_swar_add(out[i], src[i]);
+            }
+        } else {
+            for (uint32_t i = 0; i < count; i++) {
+                out[i] = led_strip_swar_add(out[i], led_strip_swar_scale(src[i], weight));
+            }
+        }
+        break;
+    case LED_STRIP_BLEND_ALPHA:
+        for (uint32_t i = 0; i < count; i++) {
+            out[i] = led_strip_swar_mix(out[i], src[i], weight);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static esp_err_t led_strip_compositor_write(led_strip_compositor_t *compositor, uint32_t start, uint32_t count)
+{
+    const uint32_t *out = compositor->out + start;
+    if (compositor->with_white) {
+        for (uint32_t i = 0; i < count; i++) {
+            ESP_RETURN_ON_ERROR(led_strip_set_pixel_rgbw(compositor->strip, start + i, (out[i] >> 16) & 0xFF, (out[i] >> 8) & 0xFF,
+                                                         out[i] & 0xFF, out[i] >> 24), TAG, "set pixel failed");
+        }
+        return ESP_OK;
+    }
+    uint8_t rgb[LED_STRIP_COMPOSITOR_BATCH_PIXELS * 3];
+    while (count) {
+        uint32_t batch = count < LED_STRIP_COMPOSITOR_BATCH_PIXELS ? count : LED_STRIP_COMPOSITOR_BATCH_PIXELS;
+        for (uint32_t i = 0; i < batch; i++) {
+            rgb[i * 3 + 0] = out[i] >> 16;
+            rgb[i * 3 + 1] = out[i] >> 8;
+            rgb[i * 3 + 2] = out[i];
+        }
+        ESP_RETURN_ON_ERROR(led_strip_set_pixels(compositor->strip, start, batch, rgb), TAG, "set pixels failed");
+        start += batch;
+        count -= batch;
+        out += batch;
+    }
+    return ESP_OK;
+}
+
+static void led_strip_compositor_add_dirty(led_strip_layer_t *layer, uint32_t start, uint32_t end)
+{
+    if (layer->dirty_start >= layer->dirty_end) {
+        layer->dirty_start = start;
+        layer->dirty_end = end;
+        return;
+    }
+    if (start < layer->dirty_start) {
+        layer->dirty_start = start;
+    }
+    if (end > layer->dirty_end) {
+        layer->dirty_end = end;
+    }
+}
+
+esp_err_t led_strip_new_compositor(const led_strip_compositor_config_t *config, led_strip_compositor_handle_t *ret_compositor)
+{
+    esp_err_t ret = ESP_OK;
+    led_strip_compositor_t *compositor = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_compositor && config->strip && config->max_leds, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->num_layers && config->num_layers <= LED_STRIP_COMPOSITOR_MAX_LAYERS, ESP_ERR_INVALID_ARG, err, TAG,
+                      "invalid number of layers");
+    ESP_GOTO_ON_FALSE(config->led_pixel_format < LED_PIXEL_FORMAT_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led_pixel_format");
+    compositor = calloc(1, sizeof(led_strip_compositor_t) + config->num_layers * sizeof(led_strip_layer_t));
+    ESP_GOTO_ON_FALSE(compositor, ESP_ERR_NO_MEM, err, TAG, "no mem for compositor");
+    // the layers and the composed pixels share one allocation
+    compositor->out = calloc((config->num_layers + 1) * config->max_leds, sizeof(uint32_t));
+    ESP_GOTO_ON_FALSE(compositor->out, ESP_ERR_NO_MEM, err, TAG, "no mem for compositor layers");
+    compositor->strip = config->strip;
+    compositor->max_leds = config->max_leds;
+    compositor->num_layers = config->num_layers;
+    compositor->with_white = config->led_pixel_format == LED_PIXEL_FORMAT_GRBW;
+    for (uint32_t i = 0; i < config->num_layers; i++) {
+        led_strip_layer_t *layer = &compositor->layers[i];
+        layer->pixels = compositor->out + (i + 1) * config->max_leds;
+        layer->mode = LED_STRIP_BLEND_REPLACE;
+        layer->opacity = 255;
+        // the first render writes the whole strip
+        layer->dirty_start = 0;
+        layer->dirty_end = config->max_leds;
+    }
+    *ret_compositor = compositor;
+    return ESP_OK;
+err:
+    if (compositor) {
+        free(compositor->out);
+        free(compositor);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_compositor_set_layer(led_strip_compositor_handle_t compositor, uint32_t layer, led_strip_blend_mode_t mode, uint8_t opacity)
+{
+    ESP_RETURN_ON_FALSE(compositor && layer < compositor->num_layers, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(mode < LED_STRIP_BLEND_INVALID, ESP_ERR_INVALID_ARG, TAG, "invalid blend mode");
+    led_strip_layer_t *l = &compositor->layers[layer];
+    if (l->mode != mode || l->opacity != opacity) {
+        l->mode = mode;
+        l->opacity = opacity;
+        led_strip_compositor_add_dirty(l, 0, compositor->max_leds);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_compositor_set_pixels(led_strip_compositor_handle_t compositor, uint32_t layer, uint32_t start, uint32_t count, const uint32_t *colors)
+{
+    ESP_RETURN_ON_FALSE(compositor && layer < compositor->num_layers && (colors || count == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(start <= compositor->max_leds && count <= compositor->max_leds - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of the maximum number of leds");
+    if (count) {
+        led_strip_layer_t *l = &compositor->layers[layer];
+        memcpy(l->pixels + start, colors, count * sizeof(uint32_t));
+        led_strip_compositor_add_dirty(l, start, start + count);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_compositor_fill(led_strip_compositor_handle_t compositor, uint32_t layer, uint32_t start, uint32_t count, uint32_t color)
+{
+    ESP_RETURN_ON_FALSE(compositor && layer < compositor->num_layers, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(start <= compositor->max_leds && count <= compositor->max_leds - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of the maximum number of leds");
+    if (count) {
+        led_strip_layer_t *l = &compositor->layers[layer];
+        for (uint32_t i = 0; i < count; i++) {
+            l->pixels[start + i] = color;
+        }
+        led_strip_compositor_add_dirty(l, start, start + count);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_compositor_get_layer_buffer(led_strip_compositor_handle_t compositor, uint32_t layer, uint32_t **ret_pixels)
+{
+    ESP_RETURN_ON_FALSE(compositor && layer < compositor->num_layers && ret_pixels, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    *ret_pixels = compositor->layers[layer].pixels;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_compositor_mark_dirty(led_strip_compositor_handle_t compositor, uint32_t layer, uint32_t start, uint32_t count)
+{
+    ESP_RETURN_ON_FALSE(compositor && layer < compositor->num_layers, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(start <= compositor->max_leds && count <= compositor->max_leds - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of the maximum number of leds");
+    if (count) {
+        led_strip_compositor_add_dirty(&compositor->layers[layer], start, start + count);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_compositor_render(led_strip_compositor_handle_t compositor, bool *ret_changed)
+{
+    ESP_RETURN_ON_FALSE(compositor, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    // a pixel depends on every layer, so the span to blend again is the union of the dirty ranges
+    uint32_t start = compositor->max_leds;
+    uint32_t end = 0;
+    for (uint32_t i = 0; i < compositor->num_layers; i++) {
+        led_strip_layer_t *l = &compositor->layers[i];
+        if (l->dirty_start < l->dirty_end) {
+            start = l->dirty_start < start ? l->dirty_start : start;
+            end = l->dirty_end > end ? l->dirty_end : end;
+            l->dirty_start = l->dirty_end = 0;
+        }
+    }
+    if (ret_changed) {
+        *ret_changed = start < end;
+    }
+    if (start >= end) {
+        return ESP_OK;
+    }
+
+    uint32_t count = end - start;
+    uint32_t *out = compositor->out + start;
+    memset(out, 0, count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < compositor->num_layers; i++) {
+        led_strip_layer_t *l = &compositor->layers[i];
+        if (l->opacity) {
+            led_strip_compositor_blend_span(out, l->pixels + start, count, l->mode, l->opacity);
+        }
+    }
+    return led_strip_compositor_write(compositor, start, count);
+}
+
+esp_err_t led_strip_del_compositor(led_strip_compositor_handle_t compositor)
+{
+    ESP_RETURN_ON_FALSE(compositor, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    free(compositor->out);
+    free(compositor);
+    return ESP_OK;
+}
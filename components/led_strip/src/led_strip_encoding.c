@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "esp_check.h"
+#include "led_strip_encoding.h"
+
+static const char *TAG = "led_strip_encoding";
+
+// position of each color component in a GRB pixel, in the order they are sent out
+static const uint8_t s_color_order_map[LED_COLOR_ORDER_INVALID][3] = {
+    [LED_COLOR_ORDER_GRB] = {0, 1, 2},
+    [LED_COLOR_ORDER_RGB] = {1, 0, 2},
+    [LED_COLOR_ORDER_BRG] = {2, 1, 0},
+    [LED_COLOR_ORDER_RBG] = {1, 2, 0},
+    [LED_COLOR_ORDER_GBR] = {0, 2, 1},
+    [LED_COLOR_ORDER_BGR] = {2, 0, 1},
+};
+
+static void led_strip_transform_update(led_strip_transform_t *transform)
+{
+    for (int i = 0; i < 256; i++) {
+        uint32_t value = transform->with_gamma ? transform->gamma[i] : i;
+        transform->lut[i] = value * (transform->brightness + 1) >> 8;
+    }
+    bool reordered = memcmp(transform->color_map, s_color_order_map[LED_COLOR_ORDER_GRB], 3) != 0;
+    transform->active = reordered || transform->with_gamma || transform->brightness != 255;
+}
+
+void led_strip_transform_init(led_strip_transform_t *transform, led_color_order_t color_order)
+{
+    memcpy(transform->color_map, s_color_order_map[color_order], 3);
+    transform->color_map[3] = 3; // the white component always goes last
+    transform->brightness = 255;
+    transform->with_gamma = false;
+    led_strip_transform_update(transform);
+}
+
+void led_strip_transform_set_brightness(led_strip_transform_t *transform, uint8_t brightness)
+{
+    transform->brightness = brightness;
+    led_strip_transform_update(transform);
+}
+
+void led_strip_transform_set_gamma_table(led_strip_transform_t *transform, const uint8_t *gamma_table)
+{
+    if (gamma_table) {
+        memcpy(transform->gamma, gamma_table, sizeof(transform->gamma));
+    }
+    transform->with_gamma = gamma_table != NULL;
+    led_strip_transform_update(transform);
+}
+
+void led_strip_get_bit_symbols(const led_strip_timing_t *timing, uint32_t resolution_hz, uint32_t *ret_bit0, uint32_t *ret_bit1)
+{
+    *ret_bit0 = LED_STRIP_SYMBOL(1, led_strip_ns_to_ticks(timing->t0h_ns, resolution_hz), 0, led_strip_ns_to_ticks(timing->t0l_ns, resolution_hz));
+    *ret_bit1 = LED_STRIP_SYMBOL(1, led_strip_ns_to_ticks(timing->t1h_ns, resolution_hz), 0, led_strip_ns_to_ticks(timing->t1l_ns, resolution_hz));
+}
+
+esp_err_t led_strip_get_reset_symbol(uint32_t reset_us, uint32_t resolution_hz, uint32_t *ret_reset)
+{
+    uint32_t reset_ticks = resolution_hz / 1000000 * reset_us / 2;
+    ESP_RETURN_ON_FALSE(reset_ticks <= LED_STRIP_SYMBOL_MAX_DURATION, ESP_ERR_INVALID_ARG, TAG, "reset time too long for the resolution");
+    *ret_reset = LED_STRIP_SYMBOL(0, reset_ticks, 0, reset_ticks);
+    return ESP_OK;
+}
+
+void led_strip_build_nibble_symbols(uint32_t bit0, uint32_t bit1, uint32_t table[16][4])
+{
+    for (int nibble = 0; nibble < 16; nibble++) {
+        for (int i = 0; i < 4; i++) {
+            // MSB first
+            table[nibble][i] = (nibble & (1 << (3 - i))) ? bit1 : bit0;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+#include "led_strip_timing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Longest duration of one half of a symbol, the duration fields are 15 bits wide
+ */
+#define LED_STRIP_SYMBOL_MAX_DURATION 0x7FFF
+
+/**
+ * @brief Pack one symbol, laid out the same as `rmt_symbol_word_t` and `rmt_item32_t`
+ */
+#define LED_STRIP_SYMBOL(level0, duration0, level1, duration1) \
+    ((uint32_t)(duration0) | (uint32_t)(level0) << 15 | (uint32_t)(duration1) << 16 | (uint32_t)(level1) << 31)
+
+/**
+ * @brief Transform that the pixels go through on their way out: color order, gamma correction and brightness
+ */
+typedef struct {
+    uint8_t color_map[4]; /*!< Position in the source pixel of each component sent out */
+    bool active;          /*!< Whether the pixels need to go through the transform at all */
+    uint8_t brightness;   /*!< Brightness scale, 255 means no scaling */
+    bool with_gamma;      /*!< Whether the gamma table is applied */
+    uint8_t gamma[256];   /*!< Gamma table */
+    uint8_t lut[256];     /*!< Gamma correction and brightness combined */
+} led_strip_transform_t;
+
+/**
+ * @brief Init a transform that only reorders the components, without gamma correction and at full brightness
+ *
+ * @param[out] transform Transform to init
+ * @param[in] color_order Order in which the color components are sent out, must be valid
+ */
+void led_strip_transform_init(led_strip_transform_t *transform, led_color_order_t color_order);
+
+/**
+ * @brief Set the brightness that the transform applies to every color component
+ *
+ * @param[in] transform Transform
+ * @param[in] brightness Brightness scale, 255 means no scaling
+ */
+void led_strip_transform_set_brightness(led_strip_transform_t *transform, uint8_t brightness);
+
+/**
+ * @brief Set the gamma table that the transform applies to every color component
+ *
+ * @param[in] transform Transform
+ * @param[in] gamma_table Table of 256 output values, which is copied into the transform. NULL to disable the gamma correction
+ */
+void led_strip_transform_set_gamma_table(led_strip_transform_t *transform, const uint8_t *gamma_table);
+
+/**
+ * @brief Transform one GRB(W) pixel into the bytes sent out
+ *
+ * @param[in] transform Transform
+ * @param[in] src Source pixel
+ * @param[out] dst Transformed pixel
+ * @param[in] bytes_per_pixel Bytes per pixel, 3 or 4
+ */
+static inline void led_strip_transform_pixel(const led_strip_transform_t *transform, const uint8_t *src, uint8_t *dst, uint8_t bytes_per_pixel)
+{
+    for (int i = 0; i < bytes_per_pixel; i++) {
+        dst[i] = transform->lut[src[transform->color_map[i]]];
+    }
+}
+
+/**
+ * @brief Work out the symbols of the two bit values of a LED model at the given resolution
+ *
+ * @param[in] timing Timing of the LED model
+ * @param[in] resolution_hz Tick resolution, in Hz
+ * @param[out] ret_bit0 Returned symbol of bit 0
+ * @param[out] ret_bit1 Returned symbol of bit 1
+ */
+void led_strip_get_bit_symbols(const led_strip_timing_t *timing, uint32_t resolution_hz, uint32_t *ret_bit0, uint32_t *ret_bit1);
+
+/**
+ * @brief Work out the reset code at the given resolution, split into the two halves of one symbol
+ *
+ * @param[in] reset_us Low time that latches the frame, in us
+ * @param[in] resolution_hz Tick resolution, in Hz
+ * @param[out] ret_reset Returned symbol of the reset code
+ * @return
+ *      - ESP_OK: Work out the reset code successfully
+ *      - ESP_ERR_INVALID_ARG: Work out the reset code failed because the reset time is too long for the resolution
+ */
+esp_err_t led_strip_get_reset_symbol(uint32_t reset_us, uint32_t resolution_hz, uint32_t *ret_reset);
+
+/**
+ * @brief Build the symbols of every 4-bit value, MSB first, so that one color byte takes two table lookups
+ *
+ * @param[in] bit0 Symbol of bit 0
+ * @param[in] bit1 Symbol of bit 1
+ * @param[out] table Symbols of every 4-bit value
+ */
+void led_strip_build_nibble_symbols(uint32_t bit0, uint32_t bit1, uint32_t table[16][4]);
+
+/**
+ * @brief Encode one color byte into 8 symbols, high nibble first
+ *
+ * @param[in] table Symbols of every 4-bit value, built by `led_strip_build_nibble_symbols`
+ * @param[in] data Color byte
+ * @param[out] symbols Buffer of at least 8 symbols
+ */
+static inline void led_strip_encode_byte_symbols(const uint32_t table[16][4], uint8_t data, uint32_t *symbols)
+{
+    memcpy(symbols, table[data >> 4], sizeof(table[0]));
+    memcpy(symbols + 4, table[data & 0x0F], sizeof(table[0]));
+}
+
+#ifdef __cplusplus
+}
+#endif
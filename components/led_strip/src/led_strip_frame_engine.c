@@ -0,0 +1,289 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <sys/cdefs.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "led_strip.h"
+#include "led_strip_frame_engine.h"
+
+#define LED_STRIP_FRAME_ENGINE_DEFAULT_STACK_SIZE 4096
+#define LED_STRIP_FRAME_ENGINE_DEFAULT_PRIORITY   5
+// frames that can be in flight at once, covers the deepest frame pipeline of the backends
+#define LED_STRIP_FRAME_ENGINE_MAX_IN_FLIGHT      4
+
+static const char *TAG = "led_strip_engine";
+
+typedef struct led_strip_frame_engine_t {
+    led_strip_handle_t strip;
+    led_strip_frame_render_cb_t on_render;
+    void *user_ctx;
+    uint32_t period_us;
+    esp_timer_handle_t timer;
+    TaskHandle_t task;
+    SemaphoreHandle_t frame_lock; // held by the engine task while a frame is in progress
+    SemaphoreHandle_t exited;     // given by the engine task right before it deletes itself
+    volatile bool running;
+    volatile bool exit;
+    bool with_done_cb;            // whether the strip reports the end of its frames
+    led_strip_event_callbacks_t prev_cbs; // callbacks registered for the strip before the engine, chained and restored on delete
+    void *prev_user_ctx;
+    int64_t start_us;             // time the engine was started, the periods are counted from it
+    uint32_t ticks;               // number of frame periods since the engine was started
+    // submit times of the frames in flight, the strips finish their frames in order
+    int64_t submit_us[LED_STRIP_FRAME_ENGINE_MAX_IN_FLIGHT];
+    uint32_t submitted;
+    uint32_t completed;
+    portMUX_TYPE lock;            // protects the counters below
+    led_strip_frame_engine_stats_t stats;
+    uint64_t render_sum_us;
+    uint64_t transmit_sum_us;
+    uint64_t jitter_sum_us;
+    uint32_t transmits;
+} led_strip_frame_engine_t;
+
+// also called from the refresh done callback, so it must be in IRAM as well
+static void IRAM_ATTR led_strip_frame_engine_add_transmit(led_strip_frame_engine_t *engine, uint32_t transmit_us)
+{
+    engine->transmit_sum_us += transmit_us;
+    engine->transmits++;
+    if (transmit_us > engine->stats.transmit_max_us) {
+        engine->stats.transmit_max_us = transmit_us;
+    }
+}
+
+// called from the ISR of the strip, see `led_strip_refresh_done_cb_t`
+static bool IRAM_ATTR led_strip_frame_engine_on_refresh_done(led_strip_handle_t strip, void *user_ctx)
+{
+    led_strip_frame_engine_t *engine = (led_strip_frame_engine_t *)user_ctx;
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&engine->lock);
+    if (engine->completed != engine->submitted) {
+        int64_t submit_us = engine->submit_us[engine->completed % LED_STRIP_FRAME_ENGINE_MAX_IN_FLIGHT];
+        engine->completed++;
+        led_strip_frame_engine_add_transmit(engine, now_us - submit_us);
+    }
+    portEXIT_CRITICAL_ISR(&engine->lock);
+    led_strip_refresh_done_cb_t prev_cb = engine->prev_cbs.on_refresh_done;
+    return prev_cb ? prev_cb(strip, engine->prev_user_ctx) : false;
+}
+
+static void led_strip_frame_engine_timer_cb(void *arg)
+{
+    led_strip_frame_engine_t *engine = (led_strip_frame_engine_t *)arg;
+    xTaskNotifyGive(engine->task);
+}
+
+static void led_strip_frame_engine_run_frame(led_strip_frame_engine_t *engine, uint32_t new_ticks)
+{
+    int64_t wake_us = esp_timer_get_time();
+    // the timer keeps ticking while a frame is late, the periods that passed meanwhile are dropped
+    engine->ticks += new_ticks;
+    uint32_t frame = engine->ticks - 1;
+    int64_t deadline_us = engine->start_us + (int64_t)(frame + 2) * engine->period_us;
+    int64_t jitter_us = wake_us - (deadline_us - engine->period_us);
+    if (jitter_us < 0) {
+        jitter_us = 0;
+    }
+
+    bool changed = engine->on_render(engine->strip, frame, engine->user_ctx);
+    int64_t render_us = esp_timer_get_time() - wake_us;
+    esp_err_t ret = ESP_OK;
+    if (changed) {
+        int64_t submit_us = esp_timer_get_time();
+        portENTER_CRITICAL(&engine->lock);
+        engine->submit_us[engine->submitted % LED_STRIP_FRAME_ENGINE_MAX_IN_FLIGHT] = submit_us;
+        engine->submitted++;
+        portEXIT_CRITICAL(&engine->lock);
+        // blocks only until a frame buffer is free, so the next frame is rendered while this one is sent out.
+        // A strip without asynchronous refresh (e.g. RMT without double buffer) is refreshed synchronously instead
+        ret = led_strip_refresh_async(engine->strip);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "refresh frame %"PRIu32" failed: %s", frame, esp_err_to_name(ret));
+        }
+    }
+    int64_t end_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&engine->lock);
+    led_strip_frame_engine_stats_t *stats = &engine->stats;
+    stats->dropped += new_ticks - 1;
+    if (changed && ret == ESP_OK) {
+        stats->frames++;
+        if (end_us > deadline_us) {
+            stats->missed_deadlines++;
+        }
+        if (!engine->with_done_cb) {
+            // without a done event, only the blocking part of the refresh can be measured
+            led_strip_frame_engine_add_transmit(engine, end_us - engine->submit_us[(engine->submitted - 1) % LED_STRIP_FRAME_ENGINE_MAX_IN_FLIGHT]);
+            engine->completed = engine->submitted;
+        }
+    } else if (changed) {
+        // the failed frame never completes
+        engine->submitted--;
+    } else {
+        stats->skipped++;
+    }
+    engine->render_sum_us += render_us;
+    if (render_us > stats->render_max_us) {
+        stats->render_max_us = render_us;
+    }
+    engine->jitter_sum_us += jitter_us;
+    if (jitter_us > stats->jitter_max_us) {
+        stats->jitter_max_us = jitter_us;
+    }
+    portEXIT_CRITICAL(&engine->lock);
+}
+
+static void led_strip_frame_engine_task(void *arg)
+{
+    led_strip_frame_engine_t *engine = (led_strip_frame_engine_t *)arg;
+    while (!engine->exit) {
+        // the notification value counts the timer ticks since the last frame
+        uint32_t new_ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xSemaphoreTake(engine->frame_lock, portMAX_DELAY);
+        if (engine->running && new_ticks) {
+            led_strip_frame_engine_run_frame(engine, new_ticks);
+        }
+        xSemaphoreGive(engine->frame_lock);
+    }
+    xSemaphoreGive(engine->exited);
+    vTaskDelete(NULL);
+}
+
+esp_err_t led_strip_new_frame_engine(const led_strip_frame_engine_config_t *config, led_strip_frame_engine_handle_t *ret_engine)
+{
+    esp_err_t ret = ESP_OK;
+    led_strip_frame_engine_t *engine = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_engine && config->strip && config->on_render, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->fps && config->fps <= 1000, ESP_ERR_INVALID_ARG, err, TAG, "invalid frame rate");
+    engine = calloc(1, sizeof(led_strip_frame_engine_t));
+    ESP_GOTO_ON_FALSE(engine, ESP_ERR_NO_MEM, err, TAG, "no mem for frame engine");
+    engine->strip = config->strip;
+    engine->on_render = config->on_render;
+    engine->user_ctx = config->user_ctx;
+    engine->period_us = 1000000 / config->fps;
+    engine->lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    engine->frame_lock = xSemaphoreCreateMutex();
+    engine->exited = xSemaphoreCreateBinary();
+    ESP_GOTO_ON_FALSE(engine->frame_lock && engine->exited, ESP_ERR_NO_MEM, err, TAG, "no mem for frame engine locks");
+
+    // keep the callback that the application may have registered, it's called after the engine's one
+    ret = led_strip_get_event_callbacks(engine->strip, &engine->prev_cbs, &engine->prev_user_ctx);
+    ESP_GOTO_ON_FALSE(ret == ESP_OK || ret == ESP_ERR_NOT_SUPPORTED, ret, err, TAG, "get refresh done callback failed");
+    if (ret == ESP_OK) {
+        led_strip_event_callbacks_t cbs = {
+            .on_refresh_done = led_strip_frame_engine_on_refresh_done,
+        };
+        ESP_GOTO_ON_ERROR(led_strip_register_event_callbacks(engine->strip, &cbs, engine), err, TAG, "register refresh done callback failed");
+        engine->with_done_cb = true;
+    }
+    ret = ESP_OK;
+
+    esp_timer_create_args_t timer_args = {
+        .callback = led_strip_frame_engine_timer_cb,
+        .arg = engine,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "led_strip_engine",
+    };
+    ESP_GOTO_ON_ERROR(esp_timer_create(&timer_args, &engine->timer), err, TAG, "create frame timer failed");
+    uint32_t stack_size = config->task_stack_size ? config->task_stack_size : LED_STRIP_FRAME_ENGINE_DEFAULT_STACK_SIZE;
+    uint32_t priority = config->task_priority ? config->task_priority : LED_STRIP_FRAME_ENGINE_DEFAULT_PRIORITY;
+    ESP_GOTO_ON_FALSE(xTaskCreate(led_strip_frame_engine_task, "led_strip_engine", stack_size, engine, priority, &engine->task) == pdPASS,
+                      ESP_ERR_NO_MEM, err, TAG, "create frame engine task failed");
+
+    *ret_engine = engine;
+    return ESP_OK;
+err:
+    if (engine) {
+        if (engine->timer) {
+            esp_timer_delete(engine->timer);
+        }
+        if (engine->with_done_cb) {
+            led_strip_register_event_callbacks(engine->strip, &engine->prev_cbs, engine->prev_user_ctx);
+        }
+        if (engine->frame_lock) {
+            vSemaphoreDelete(engine->frame_lock);
+        }
+        if (engine->exited) {
+            vSemaphoreDelete(engine->exited);
+        }
+        free(engine);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_frame_engine_start(led_strip_frame_engine_handle_t engine)
+{
+    ESP_RETURN_ON_FALSE(engine, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!engine->running, ESP_ERR_INVALID_STATE, TAG, "engine is already running");
+    xSemaphoreTake(engine->frame_lock, portMAX_DELAY);
+    engine->ticks = 0;
+    engine->start_us = esp_timer_get_time();
+    engine->running = true;
+    esp_err_t ret = esp_timer_start_periodic(engine->timer, engine->period_us);
+    if (ret != ESP_OK) {
+        engine->running = false;
+    }
+    xSemaphoreGive(engine->frame_lock);
+    ESP_RETURN_ON_ERROR(ret, TAG, "start frame timer failed");
+    return ESP_OK;
+}
+
+esp_err_t led_strip_frame_engine_stop(led_strip_frame_engine_handle_t engine)
+{
+    ESP_RETURN_ON_FALSE(engine, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(engine->running, ESP_ERR_INVALID_STATE, TAG, "engine is not running");
+    ESP_RETURN_ON_ERROR(esp_timer_stop(engine->timer), TAG, "stop frame timer failed");
+    // wait for the frame in progress, then for the strip to send it out
+    xSemaphoreTake(engine->frame_lock, portMAX_DELAY);
+    engine->running = false;
+    xSemaphoreGive(engine->frame_lock);
+    esp_err_t ret = led_strip_wait_refresh_done(engine->strip, -1);
+    ESP_RETURN_ON_FALSE(ret == ESP_OK || ret == ESP_ERR_NOT_SUPPORTED, ret, TAG, "wait last frame failed");
+    return ESP_OK;
+}
+
+esp_err_t led_strip_frame_engine_get_stats(led_strip_frame_engine_handle_t engine, led_strip_frame_engine_stats_t *ret_stats)
+{
+    ESP_RETURN_ON_FALSE(engine && ret_stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    portENTER_CRITICAL(&engine->lock);
+    *ret_stats = engine->stats;
+    uint32_t rendered = engine->stats.frames + engine->stats.skipped;
+    if (rendered) {
+        ret_stats->render_avg_us = engine->render_sum_us / rendered;
+        ret_stats->jitter_avg_us = engine->jitter_sum_us / rendered;
+    }
+    if (engine->transmits) {
+        ret_stats->transmit_avg_us = engine->transmit_sum_us / engine->transmits;
+    }
+    portEXIT_CRITICAL(&engine->lock);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_del_frame_engine(led_strip_frame_engine_handle_t engine)
+{
+    ESP_RETURN_ON_FALSE(engine, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (engine->running) {
+        ESP_RETURN_ON_ERROR(led_strip_frame_engine_stop(engine), TAG, "stop engine failed");
+    }
+    ESP_RETURN_ON_ERROR(esp_timer_delete(engine->timer), TAG, "delete frame timer failed");
+    engine->exit = true;
+    xTaskNotifyGive(engine->task);
+    xSemaphoreTake(engine->exited, portMAX_DELAY);
+    if (engine->with_done_cb) {
+        ESP_RETURN_ON_ERROR(led_strip_register_event_callbacks(engine->strip, &engine->prev_cbs, engine->prev_user_ctx), TAG,
+                            "restore refresh done callback failed");
+    }
+    vSemaphoreDelete(engine->frame_lock);
+    vSemaphoreDelete(engine->exited);
+    free(engine);
+    return ESP_OK;
+}
@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "led_strip.h"
+#include "led_strip_matrix.h"
+
+static const char *TAG = "led_strip_matrix";
+
+typedef struct led_strip_matrix_t {
+    led_strip_handle_t strip;
+    uint32_t width;      // width of the drawn image, after the rotation
+    uint32_t height;     // height of the drawn image, after the rotation
+    uint32_t end_led;    // one past the last LED of the panel in the strip
+    uint8_t bytes_per_pixel;
+    uint16_t table[];    // strip index of every pixel of the image, row by row
+} led_strip_matrix_t;
+
+// strip index of a LED of the unrotated panel
+static uint32_t led_strip_matrix_panel_index(const led_strip_matrix_config_t *config, uint32_t px, uint32_t py)
+{
+    if (config->order == LED_STRIP_MATRIX_COLUMN_MAJOR) {
+        if (config->flags.serpentine && (px & 1)) {
+            py = config->height - 1 - py;
+        }
+        return config->first_led + px * config->height + py;
+    }
+    if (config->flags.serpentine && (py & 1)) {
+        px = config->width - 1 - px;
+    }
+    return config->first_led + py * config->width + px;
+}
+
+// copy rows of pixels through the table, a zero pixel step repeats the same color
+static esp_err_t led_strip_matrix_blit(led_strip_matrix_t *matrix, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                       const uint8_t *rgb, uint32_t pixel_step, uint32_t row_step)
+{
+    ESP_RETURN_ON_FALSE(x <= matrix->width && width <= matrix->width - x && y <= matrix->height && height <= matrix->height - y,
+                        ESP_ERR_INVALID_ARG, TAG, "rectangle out of the matrix");
+    uint8_t *buf = NULL;
+    size_t buf_size = 0;
+    esp_err_t ret = led_strip_get_buffer(matrix->strip, &buf, &buf_size);
+    if (ret == ESP_ERR_NOT_SUPPORTED) {
+        // the backend keeps the pixels encoded, go through the strip API
+        for (uint32_t r = 0; r < height; r++) {
+            const uint16_t *index = matrix->table + (y + r) * matrix->width + x;
+            const uint8_t *src = rgb + r * row_step;
+            for (uint32_t i = 0; i < width; i++, src += pixel_step) {
+                ESP_RETURN_ON_ERROR(led_strip_set_pixel(matrix->strip, index[i], src[0], src[1], src[2]), TAG, "set pixel failed");
+            }
+        }
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "get strip buffer failed");
+    // the buffer is fetched on every call, as it's swapped by the double buffered refresh
+    ESP_RETURN_ON_FALSE(buf_size >= matrix->end_led * matrix->bytes_per_pixel, ESP_ERR_INVALID_ARG, TAG, "matrix doesn't fit the LED strip");
+    uint8_t bytes_per_pixel = matrix->bytes_per_pixel;
+    for (uint32_t r = 0; r < height; r++) {
+        const uint16_t *index = matrix->table + (y + r) * matrix->width + x;
+        const uint8_t *src = rgb + r * row_step;
+        for (uint32_t i = 0; i < width; i++, src += pixel_step) {
+            // In the order of GRB
+            uint8_t *pixel = buf + index[i] * bytes_per_pixel;
+            pixel[0] = src[1];
+            pixel[1] = src[0];
+            pixel[2] = src[2];
+            if (bytes_per_pixel > 3) {
+                pixel[3] = 0;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_matrix(const led_strip_matrix_config_t *config, led_strip_matrix_handle_t *ret_matrix)
+{
+    esp_err_t ret = ESP_OK;
+    led_strip_matrix_t *matrix = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_matrix && config->strip && config->width && config->height, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->led_pixel_format < LED_PIXEL_FORMAT_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led_pixel_format");
+    ESP_GOTO_ON_FALSE(config->order < LED_STRIP_MATRIX_ORDER_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid order");
+    ESP_GOTO_ON_FALSE(config->rotation < LED_STRIP_MATRIX_ROTATE_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid rotation");
+    uint64_t end_led = (uint64_t)config->width * config->height + config->first_led;
+    ESP_GOTO_ON_FALSE(end_led <= UINT16_MAX + 1, ESP_ERR_INVALID_ARG, err, TAG, "matrix takes too many LEDs");
+    uint32_t num_pixels = config->width * config->height;
+    matrix = calloc(1, sizeof(led_strip_matrix_t) + num_pixels * sizeof(uint16_t));
+    ESP_GOTO_ON_FALSE(matrix, ESP_ERR_NO_MEM, err, TAG, "no mem for matrix");
+    matrix->strip = config->strip;
+    matrix->end_led = end_led;
+    matrix->bytes_per_pixel = config->led_pixel_format == LED_PIXEL_FORMAT_GRBW ? 4 : 3;
+    bool swap = config->rotation == LED_STRIP_MATRIX_ROTATE_90 || config->rotation == LED_STRIP_MATRIX_ROTATE_270;
+    matrix->width = swap ? config->height : config->width;
+    matrix->height = swap ? config->width : config->height;
+
+    uint32_t w = matrix->width;
+    uint32_t h = matrix->height;
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            uint32_t fx = config->flags.flip_x ? w - 1 - x : x;
+            uint32_t fy = config->flags.flip_y ? h - 1 - y : y;
+            uint32_t px = fx;
+            uint32_t py = fy;
+            // rotate the image clockwise onto the panel
+            switch (config->rotation) {
+            case LED_STRIP_MATRIX_ROTATE_90:
+                px = config->width - 1 - fy;
+                py = fx;
+                break;
+            case LED_STRIP_MATRIX_ROTATE_180:
+                px = config->width - 1 - fx;
+                py = config->height - 1 - fy;
+                break;
+            case LED_STRIP_MATRIX_ROTATE_270:
+                px = fy;
+                py = config->height - 1 - fx;
+                break;
+            default:
+                break;
+            }
+            matrix->table[y * w + x] = led_strip_matrix_panel_index(config, px, py);
+        }
+    }
+    *ret_matrix = matrix;
+    return ESP_OK;
+err:
+    free(matrix);
+    return ret;
+}
+
+esp_err_t led_strip_matrix_get_size(led_strip_matrix_handle_t matrix, uint32_t *ret_width, uint32_t *ret_height)
+{
+    ESP_RETURN_ON_FALSE(matrix && ret_width && ret_height, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    *ret_width = matrix->width;
+    *ret_height = matrix->height;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_matrix_get_index_table(led_strip_matrix_handle_t matrix, const uint16_t **ret_table)
+{
+    ESP_RETURN_ON_FALSE(matrix && ret_table, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    *ret_table = matrix->table;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_matrix_set_pixel(led_strip_matrix_handle_t matrix, uint32_t x, uint32_t y, uint8_t red, uint8_t green, uint8_t blue)
+{
+    ESP_RETURN_ON_FALSE(matrix, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(x < matrix->width && y < matrix->height, ESP_ERR_INVALID_ARG, TAG, "pixel out of the matrix");
+    return led_strip_set_pixel(matrix->strip, matrix->table[y * matrix->width + x], red, green, blue);
+}
+
+esp_err_t led_strip_matrix_blit_row(led_strip_matrix_handle_t matrix, uint32_t x, uint32_t y, uint32_t count, const uint8_t *rgb)
+{
+    ESP_RETURN_ON_FALSE(matrix && (rgb || count == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return led_strip_matrix_blit(matrix, x, y, count, 1, rgb, 3, 0);
+}
+
+esp_err_t led_strip_matrix_blit_rect(led_strip_matrix_handle_t matrix, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                     const uint8_t *rgb, uint32_t stride)
+{
+    ESP_RETURN_ON_FALSE(matrix && (rgb || width == 0 || height == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    stride = stride ? stride : width;
+    ESP_RETURN_ON_FALSE(stride >= width, ESP_ERR_INVALID_ARG, TAG, "stride shorter than the rectangle");
+    return led_strip_matrix_blit(matrix, x, y, width, height, rgb, 3, stride * 3);
+}
+
+esp_err_t led_strip_matrix_fill_rect(led_strip_matrix_handle_t matrix, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                     uint8_t red, uint8_t green, uint8_t blue)
+{
+    ESP_RETURN_ON_FALSE(matrix, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    const uint8_t rgb[3] = {red, green, blue};
+    return led_strip_matrix_blit(matrix, x, y, width, height, rgb, 0, 0);
+}
+
+esp_err_t led_strip_del_matrix(led_strip_matrix_handle_t matrix)
+{
+    ESP_RETURN_ON_FALSE(matrix, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    free(matrix);
+    return ESP_OK;
+}
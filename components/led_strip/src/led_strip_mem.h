@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include "esp_memory_utils.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Account a memory block of the LED strip into the memory report, by the region it's placed in
+ *
+ * @param[in,out] report Memory report
+ * @param[in] ptr Memory block, NULL is ignored
+ * @param[in] size Size of the memory block
+ */
+static inline void led_strip_mem_report_add(led_strip_mem_report_t *report, const void *ptr, size_t size)
+{
+    if (!ptr) {
+        return;
+    }
+    if (esp_ptr_external_ram(ptr)) {
+        report->external += size;
+        return;
+    }
+    report->internal += size;
+    if (esp_ptr_dma_capable(ptr)) {
+        report->dma += size;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
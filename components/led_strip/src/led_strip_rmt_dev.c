@@ -0,0 +1,905 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "soc/soc_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/rmt_tx.h"
+#include "driver/gpio.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_rmt_encoder.h"
+#include "led_strip_mem.h"
+#include "led_strip_timing.h"
+
+#define LED_STRIP_RMT_DEFAULT_RESOLUTION 10000000 // 10MHz resolution
+// the memory size of each RMT channel, in words (4 bytes)
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS 64
+#else
+#define LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS 48
+#endif
+// upper bound of the auto-sized DMA buffer, 4KB of internal memory, the refill interrupt comes every half of it (about 21 GRB pixels)
+#define LED_STRIP_RMT_DMA_MAX_MEM_BLOCK_SYMBOLS 1024
+// the DMA buffer is sized in steps of 64 symbols
+#define LED_STRIP_RMT_DMA_MEM_BLOCK_ALIGN 64
+// upper bound of the auto-sized transaction queue, the depth that was used for every strip before
+#define LED_STRIP_RMT_MAX_TRANS_QUEUE_DEPTH 4
+// maximum number of strips that share the channels of a pool
+#define LED_STRIP_RMT_POOL_MAX_STRIPS 16
+// slack on the expected frame time for the latency of starting the transmission and of the done interrupt
+#define LED_STRIP_RMT_UNDERRUN_MARGIN_US 20
+
+static const char *TAG = "led_strip_rmt";
+
+typedef struct {
+    led_strip_t base;
+    rmt_channel_handle_t rmt_chan;
+    rmt_encoder_handle_t strip_encoder;
+    uint32_t strip_len;
+    uint32_t active_len; // number of leading pixels sent by a refresh
+    uint32_t sent_len;   // number of pixels sent by the last frame, the ones beyond the active length need to be blanked once
+    uint8_t bytes_per_pixel;
+    uint8_t *pixel_buf;  // buffer that the pixels are drawn into
+    uint8_t *front_buf;  // buffer that is being sent out, only used in double buffer mode
+    led_strip_refresh_done_cb_t on_refresh_done;
+    void *user_ctx;
+    bool grouped;        // the channel is bound to the sync manager of a strip group
+    size_t buffers_size; // size of the pixel buffers allocated by the driver
+    uint8_t *ext_buffers; // pixel buffers in external RAM, NULL if they follow the object
+    uint32_t bit_ns;     // wire time of one bit
+    uint32_t reset_us;   // wire time of the reset code
+    uint32_t underrun_slack_us; // how much longer than its wire time a frame can take before it's counted as an underrun
+    int64_t tx_start_us; // time the last frame was handed to the RMT driver
+    uint32_t tx_wire_us; // wire time of the last frame
+    led_strip_rmt_stats_t stats;
+    uint32_t fps_frames; // frame count when the frame rate was last reported
+    int64_t fps_since_us; // time the frame rate was last reported
+    led_strip_rmt_pool_handle_t pool; // pool that lends the RMT channel, NULL if the strip owns its channel
+    int gpio_num;        // GPIO of a pool strip
+    bool invert_out;     // whether the output of a pool strip is inverted
+    uint8_t buffers[];
+} led_strip_rmt_obj;
+
+typedef struct {
+    rmt_channel_handle_t chan;
+    led_strip_rmt_obj *owner; // strip whose GPIO the channel is created on
+    bool busy;                // the channel is sending a frame of the current pool refresh
+} led_strip_rmt_pool_slot_t;
+
+struct led_strip_rmt_pool_t {
+    rmt_tx_channel_config_t chan_config; // shared by all the channels, except for the GPIO
+    led_color_order_t color_order;
+    uint32_t frame_budget_us;
+    SemaphoreHandle_t lock;   // serializes the use of the channels
+    size_t num_strips;
+    size_t next_strip;        // first strip sent by the next pool refresh
+    size_t next_victim;       // next slot to take over when all of them are owned
+    led_strip_rmt_obj *strips[LED_STRIP_RMT_POOL_MAX_STRIPS];
+    size_t num_slots;
+    led_strip_rmt_pool_slot_t slots[];
+};
+
+struct led_strip_rmt_group_t {
+    rmt_sync_manager_handle_t synchro;
+    size_t num_strips;
+    led_strip_rmt_obj *strips[];
+};
+
+static esp_err_t led_strip_rmt_pool_strip_refresh(led_strip_t *strip);
+
+// runs in the RMT interrupt, which can be serviced while the flash cache is disabled (RMT_ISR_IRAM_SAFE), so it stays in IRAM
+static bool IRAM_ATTR led_strip_rmt_on_trans_done(rmt_channel_handle_t tx_chan, const rmt_tx_done_event_data_t *edata, void *user_ctx)
+{
+    led_strip_rmt_obj *rmt_strip = (led_strip_rmt_obj *)user_ctx;
+    led_strip_rmt_stats_t *stats = &rmt_strip->stats;
+    // the first encode call fills the RMT memory before the transmission starts, the others are refills
+    uint32_t refills = rmt_led_strip_encoder_get_encode_calls(rmt_strip->strip_encoder) - 1;
+    stats->frames++;
+    stats->last_refills = refills;
+    if (refills > stats->max_refills) {
+        stats->max_refills = refills;
+    }
+    // a late refill lets the RMT send out the stale half of its memory again, which stretches the frame
+    if (esp_timer_get_time() - rmt_strip->tx_start_us > rmt_strip->tx_wire_us + rmt_strip->underrun_slack_us) {
+        stats->underruns++;
+    }
+    led_strip_refresh_done_cb_t cb = rmt_strip->on_refresh_done;
+    if (cb) {
+        return cb(&rmt_strip->base, rmt_strip->user_ctx);
+    }
+    return false;
+}
+
+static esp_err_t led_strip_rmt_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(index < rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    uint32_t start = index * rmt_strip->bytes_per_pixel;
+    // In thr order of GRB, as LED strip like WS2812 sends out pixels in this order
+    rmt_strip->pixel_buf[start + 0] = green & 0xFF;
+    rmt_strip->pixel_buf[start + 1] = red & 0xFF;
+    rmt_strip->pixel_buf[start + 2] = blue & 0xFF;
+    if (rmt_strip->bytes_per_pixel > 3) {
+        rmt_strip->pixel_buf[start + 3] = 0;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(index < rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(rmt_strip->bytes_per_pixel == 4, ESP_ERR_INVALID_ARG, TAG, "wrong LED pixel format, expected 4 bytes per pixel");
+    uint8_t *buf_start = rmt_strip->pixel_buf + index * 4;
+    // SK6812 component order is GRBW
+    *buf_start = green & 0xFF;
+    *++buf_start = red & 0xFF;
+    *++buf_start = blue & 0xFF;
+    *++buf_start = white & 0xFF;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(start <= rmt_strip->strip_len && count <= rmt_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint8_t bytes_per_pixel = rmt_strip->bytes_per_pixel;
+    uint8_t *buf = rmt_strip->pixel_buf + start * bytes_per_pixel;
+    for (uint32_t i = 0; i < count; i++) {
+        // In the order of GRB
+        buf[0] = rgb[1];
+        buf[1] = rgb[0];
+        buf[2] = rgb[2];
+        if (bytes_per_pixel > 3) {
+            buf[3] = 0;
+        }
+        buf += bytes_per_pixel;
+        rgb += 3;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_fill(led_strip_t *strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(start <= rmt_strip->strip_len && count <= rmt_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint8_t bytes_per_pixel = rmt_strip->bytes_per_pixel;
+    const uint8_t pixel[4] = {green & 0xFF, red & 0xFF, blue & 0xFF, 0};
+    uint8_t *buf = rmt_strip->pixel_buf + start * bytes_per_pixel;
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(buf, pixel, bytes_per_pixel);
+        buf += bytes_per_pixel;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_write_frame(led_strip_t *strip, const uint8_t *frame, size_t size)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(size % rmt_strip->bytes_per_pixel == 0 && size <= rmt_strip->strip_len * rmt_strip->bytes_per_pixel, ESP_ERR_INVALID_ARG, TAG,
+                        "frame size doesn't fit the LED strip");
+    memcpy(rmt_strip->pixel_buf, frame, size);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_get_buffer(led_strip_t *strip, uint8_t **ret_buf, size_t *ret_size)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    *ret_buf = rmt_strip->pixel_buf;
+    *ret_size = rmt_strip->strip_len * rmt_strip->bytes_per_pixel;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_active_length(led_strip_t *strip, uint32_t length)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(length && length <= rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "active length out of maximum number of LEDs");
+    rmt_strip->active_len = length;
+    return ESP_OK;
+}
+
+// wire time of a frame of `size` bytes
+static inline uint32_t led_strip_rmt_wire_us(led_strip_rmt_obj *rmt_strip, size_t size)
+{
+    return size * 8 * rmt_strip->bit_ns / 1000 + rmt_strip->reset_us;
+}
+
+// hand the frame in `buf` over to the RMT driver
+static esp_err_t led_strip_rmt_transmit(led_strip_rmt_obj *rmt_strip, uint8_t *buf)
+{
+    rmt_transmit_config_t tx_conf = {
+        .loop_count = 0,
+    };
+    // the pixels that the last frame lit beyond the active length are sent as zeros by the encoder, `buf` stays untouched
+    uint32_t len = rmt_strip->sent_len > rmt_strip->active_len ? rmt_strip->sent_len : rmt_strip->active_len;
+    size_t size = len * rmt_strip->bytes_per_pixel;
+    ESP_RETURN_ON_ERROR(rmt_led_strip_encoder_set_blank_from(rmt_strip->strip_encoder, rmt_strip->active_len), TAG, "set blanked pixels failed");
+    rmt_strip->tx_wire_us = led_strip_rmt_wire_us(rmt_strip, size);
+    rmt_strip->tx_start_us = esp_timer_get_time();
+    ESP_RETURN_ON_ERROR(rmt_transmit(rmt_strip->rmt_chan, rmt_strip->strip_encoder, buf, size, &tx_conf), TAG, "RMT transmit failed");
+    // only a frame handed to the driver has blanked the tail
+    rmt_strip->sent_len = rmt_strip->active_len;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_refresh(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(!rmt_strip->grouped, ESP_ERR_INVALID_STATE, TAG, "strip is grouped, refresh it through the group");
+
+    if (rmt_strip->front_buf) {
+        // in double buffer mode the channel stays enabled, make sure the previous asynchronous frame is out first
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+        ESP_RETURN_ON_ERROR(led_strip_rmt_transmit(rmt_strip, rmt_strip->pixel_buf), TAG, "transmit pixels by RMT failed");
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+        return ESP_OK;
+    }
+
+    ESP_RETURN_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), TAG, "enable RMT channel failed");
+    ESP_RETURN_ON_ERROR(led_strip_rmt_transmit(rmt_strip, rmt_strip->pixel_buf), TAG, "transmit pixels by RMT failed");
+    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+    ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), TAG, "disable RMT channel failed");
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_refresh_async(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(!rmt_strip->grouped, ESP_ERR_INVALID_STATE, TAG, "strip is grouped, refresh it through the group");
+
+    // the front buffer can only be handed back for drawing once the previous frame is completely sent out
+    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+    uint8_t *frame = rmt_strip->pixel_buf;
+    rmt_strip->pixel_buf = rmt_strip->front_buf;
+    rmt_strip->front_buf = frame;
+    ESP_RETURN_ON_ERROR(led_strip_rmt_transmit(rmt_strip, frame), TAG, "transmit pixels by RMT failed");
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_wait_refresh_done(led_strip_t *strip, int32_t timeout_ms)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    // not logging here, as a timeout is an expected result when polling
+    return rmt_tx_wait_all_done(rmt_strip->rmt_chan, timeout_ms);
+}
+
+static esp_err_t led_strip_rmt_register_event_callbacks(led_strip_t *strip, const led_strip_event_callbacks_t *cbs, void *user_ctx)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    rmt_strip->user_ctx = user_ctx;
+    rmt_strip->on_refresh_done = cbs->on_refresh_done;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_get_event_callbacks(led_strip_t *strip, led_strip_event_callbacks_t *ret_cbs, void **ret_user_ctx)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ret_cbs->on_refresh_done = rmt_strip->on_refresh_done;
+    *ret_user_ctx = rmt_strip->user_ctx;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_brightness(led_strip_t *strip, uint8_t brightness)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    return rmt_led_strip_encoder_set_brightness(rmt_strip->strip_encoder, brightness);
+}
+
+static esp_err_t led_strip_rmt_set_gamma_table(led_strip_t *strip, const uint8_t *gamma_table)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    return rmt_led_strip_encoder_set_gamma_table(rmt_strip->strip_encoder, gamma_table);
+}
+
+static esp_err_t led_strip_rmt_get_mem_report(led_strip_t *strip, led_strip_mem_report_t *report)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    if (rmt_strip->ext_buffers) {
+        led_strip_mem_report_add(report, rmt_strip, sizeof(led_strip_rmt_obj));
+        led_strip_mem_report_add(report, rmt_strip->ext_buffers, rmt_strip->buffers_size);
+    } else {
+        led_strip_mem_report_add(report, rmt_strip, sizeof(led_strip_rmt_obj) + rmt_strip->buffers_size);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_clear(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    // Write zero to turn off all leds
+    memset(rmt_strip->pixel_buf, 0, rmt_strip->strip_len * rmt_strip->bytes_per_pixel);
+    return strip->refresh(strip);
+}
+
+static esp_err_t led_strip_rmt_del(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(!rmt_strip->grouped, ESP_ERR_INVALID_STATE, TAG, "strip is grouped, delete the group first");
+    if (rmt_strip->front_buf) {
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+        ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), TAG, "disable RMT channel failed");
+    }
+    ESP_RETURN_ON_ERROR(rmt_del_channel(rmt_strip->rmt_chan), TAG, "delete RMT channel failed");
+    ESP_RETURN_ON_ERROR(rmt_del_encoder(rmt_strip->strip_encoder), TAG, "delete strip encoder failed");
+    free(rmt_strip->ext_buffers);
+    free(rmt_strip);
+    return ESP_OK;
+}
+
+// size the RMT memory of the channel from the length of the frame, so that long strips don't take a refill interrupt every pixel
+static void led_strip_rmt_auto_size(size_t frame_symbols, bool borrow_mem_block, rmt_tx_channel_config_t *chan_config)
+{
+    // DMA is only used when asked for, chips with RMT DMA have a single DMA capable TX channel, which would go to the first long strip created
+    if (chan_config->flags.with_dma) {
+        size_t symbols = (frame_symbols + LED_STRIP_RMT_DMA_MEM_BLOCK_ALIGN - 1) & ~(size_t)(LED_STRIP_RMT_DMA_MEM_BLOCK_ALIGN - 1);
+        chan_config->mem_block_symbols = symbols < LED_STRIP_RMT_DMA_MAX_MEM_BLOCK_SYMBOLS ? symbols : LED_STRIP_RMT_DMA_MAX_MEM_BLOCK_SYMBOLS;
+    } else if (borrow_mem_block && frame_symbols > LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS) {
+        // borrow the memory block of the next channel, which halves the refill interrupts but leaves one TX channel less for other strips
+        chan_config->mem_block_symbols = 2 * LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS;
+    }
+}
+
+// size the transaction queue from the wire time of a frame: frames shorter than a tick may be queued back to back, a long one never has more than one waiting
+static uint32_t led_strip_rmt_queue_depth(uint32_t frame_us)
+{
+    uint32_t depth = portTICK_PERIOD_MS * 1000 / frame_us + 1;
+    return depth < LED_STRIP_RMT_MAX_TRANS_QUEUE_DEPTH ? depth : LED_STRIP_RMT_MAX_TRANS_QUEUE_DEPTH;
+}
+
+// record the memory setup of the channel that sends the strip out
+static void led_strip_rmt_set_chan_config(led_strip_rmt_obj *rmt_strip, const rmt_tx_channel_config_t *chan_config)
+{
+    rmt_strip->stats.mem_block_symbols = chan_config->mem_block_symbols;
+    rmt_strip->stats.trans_queue_depth = chan_config->trans_queue_depth;
+    rmt_strip->stats.with_dma = chan_config->flags.with_dma;
+    rmt_strip->underrun_slack_us = chan_config->mem_block_symbols / 2 * rmt_strip->bit_ns / 1000 + LED_STRIP_RMT_UNDERRUN_MARGIN_US;
+}
+
+static void led_strip_rmt_free_obj(led_strip_rmt_obj *rmt_strip)
+{
+    if (rmt_strip->strip_encoder) {
+        rmt_del_encoder(rmt_strip->strip_encoder);
+    }
+    free(rmt_strip->ext_buffers);
+    free(rmt_strip);
+}
+
+// create the strip object with its pixel buffers and encoder, the RMT channel is left to the caller
+static esp_err_t led_strip_rmt_new_obj(const led_strip_config_t *led_config, uint32_t resolution, led_color_order_t color_order, bool double_buffer,
+                                       led_strip_rmt_obj **ret_strip)
+{
+    led_strip_rmt_obj *rmt_strip = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config->led_pixel_format < LED_PIXEL_FORMAT_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led_pixel_format");
+    uint8_t bytes_per_pixel = 3;
+    if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRBW) {
+        bytes_per_pixel = 4;
+    } else if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRB) {
+        bytes_per_pixel = 3;
+    } else {
+        assert(false);
+    }
+    ESP_GOTO_ON_FALSE(!led_config->pixel_buf || !double_buffer, ESP_ERR_INVALID_ARG, err, TAG, "double buffer can't use a caller-owned pixel buffer");
+    size_t frame_size = led_config->max_leds * bytes_per_pixel;
+    size_t num_buffers = double_buffer ? 2 : 1;
+    if (led_config->pixel_buf) {
+        num_buffers = 0;
+    }
+    bool in_psram = led_config->flags.pixel_buf_in_psram && num_buffers;
+#if CONFIG_RMT_ISR_IRAM_SAFE
+    // the encoder reads the pixels in the RMT interrupt, which must not touch the external RAM when the cache is disabled
+    ESP_GOTO_ON_FALSE(!in_psram, ESP_ERR_NOT_SUPPORTED, err, TAG, "PSRAM pixel buffer can't be used with RMT_ISR_IRAM_SAFE");
+#endif
+    rmt_strip = calloc(1, sizeof(led_strip_rmt_obj) + (in_psram ? 0 : frame_size * num_buffers));
+    ESP_GOTO_ON_FALSE(rmt_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for rmt strip");
+    rmt_strip->buffers_size = frame_size * num_buffers;
+    uint8_t *buffers = rmt_strip->buffers;
+    if (in_psram) {
+        // the encoder packs the pixels straight into the RMT symbol memory, which acts as the internal bounce buffer
+        rmt_strip->ext_buffers = heap_caps_calloc(1, frame_size * num_buffers, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        ESP_GOTO_ON_FALSE(rmt_strip->ext_buffers, ESP_ERR_NO_MEM, err, TAG, "no mem for pixel buffers in PSRAM");
+        buffers = rmt_strip->ext_buffers;
+    }
+    rmt_strip->pixel_buf = led_config->pixel_buf ? led_config->pixel_buf : buffers;
+
+    led_strip_encoder_config_t strip_encoder_conf = {
+        .resolution = resolution,
+        .led_model = led_config->led_model,
+        .reset_us = led_config->reset_us,
+        .bytes_per_pixel = bytes_per_pixel,
+        .color_order = color_order,
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_led_strip_encoder(&strip_encoder_conf, &rmt_strip->strip_encoder), err, TAG, "create LED strip encoder failed");
+    // the encoder has checked the model, work out the wire time of a frame for the underrun detection
+    const led_strip_timing_t *timing = led_strip_get_timing(led_config->led_model);
+    uint32_t bit0_ns = timing->t0h_ns + timing->t0l_ns;
+    uint32_t bit1_ns = timing->t1h_ns + timing->t1l_ns;
+    rmt_strip->bit_ns = bit0_ns > bit1_ns ? bit0_ns : bit1_ns;
+    rmt_strip->reset_us = led_config->reset_us ? led_config->reset_us : timing->reset_us;
+
+    rmt_strip->bytes_per_pixel = bytes_per_pixel;
+    rmt_strip->strip_len = led_config->max_leds;
+    rmt_strip->active_len = led_config->max_leds;
+    rmt_strip->sent_len = led_config->max_leds;
+    rmt_strip->fps_since_us = esp_timer_get_time();
+    rmt_strip->base.set_pixel = led_strip_rmt_set_pixel;
+    rmt_strip->base.set_pixel_rgbw = led_strip_rmt_set_pixel_rgbw;
+    rmt_strip->base.set_pixels = led_strip_rmt_set_pixels;
+    rmt_strip->base.fill = led_strip_rmt_fill;
+    rmt_strip->base.write_frame = led_strip_rmt_write_frame;
+    rmt_strip->base.get_buffer = led_strip_rmt_get_buffer;
+    rmt_strip->base.set_active_length = led_strip_rmt_set_active_length;
+    rmt_strip->base.refresh = led_strip_rmt_refresh;
+    // without a second buffer there is nothing to draw into while a frame is sent, `led_strip_refresh_async` falls back to `refresh`
+    rmt_strip->base.refresh_async = double_buffer ? led_strip_rmt_refresh_async : NULL;
+    rmt_strip->base.wait_refresh_done = led_strip_rmt_wait_refresh_done;
+    rmt_strip->base.register_event_callbacks = led_strip_rmt_register_event_callbacks;
+    rmt_strip->base.get_event_callbacks = led_strip_rmt_get_event_callbacks;
+    rmt_strip->base.clear = led_strip_rmt_clear;
+    rmt_strip->base.set_brightness = led_strip_rmt_set_brightness;
+    rmt_strip->base.set_gamma_table = led_strip_rmt_set_gamma_table;
+    rmt_strip->base.get_mem_report = led_strip_rmt_get_mem_report;
+    rmt_strip->base.del = led_strip_rmt_del;
+
+    *ret_strip = rmt_strip;
+    return ESP_OK;
+err:
+    if (rmt_strip) {
+        led_strip_rmt_free_obj(rmt_strip);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config, led_strip_handle_t *ret_strip)
+{
+    led_strip_rmt_obj *rmt_strip = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config && rmt_config && ret_strip, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    uint32_t resolution = rmt_config->resolution_hz ? rmt_config->resolution_hz : LED_STRIP_RMT_DEFAULT_RESOLUTION;
+    ESP_GOTO_ON_ERROR(led_strip_rmt_new_obj(led_config, resolution, rmt_config->color_order, rmt_config->flags.double_buffer, &rmt_strip),
+                      err, TAG, "create LED strip object failed");
+
+    // for backward compatibility, if the user does not set the clk_src, use the default value
+    rmt_clock_source_t clk_src = RMT_CLK_SRC_DEFAULT;
+    if (rmt_config->clk_src) {
+        clk_src = rmt_config->clk_src;
+    }
+    rmt_tx_channel_config_t rmt_chan_config = {
+        .clk_src = clk_src,
+        .gpio_num = led_config->strip_gpio_num,
+        .mem_block_symbols = LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS,
+        .resolution_hz = resolution,
+        .trans_queue_depth = led_strip_rmt_queue_depth(led_strip_rmt_wire_us(rmt_strip, rmt_strip->strip_len * rmt_strip->bytes_per_pixel)),
+        .flags.with_dma = rmt_config->flags.with_dma,
+        .flags.invert_out = led_config->flags.invert_out,
+    };
+    if (rmt_config->mem_block_symbols) {
+        // override the auto-sized value if the user sets it
+        rmt_chan_config.mem_block_symbols = rmt_config->mem_block_symbols;
+    } else {
+        led_strip_rmt_auto_size(rmt_strip->strip_len * rmt_strip->bytes_per_pixel * 8 + 1, rmt_config->flags.borrow_mem_block, &rmt_chan_config);
+    }
+    ret = rmt_new_tx_channel(&rmt_chan_config, &rmt_strip->rmt_chan);
+    if (ret != ESP_OK && !rmt_config->mem_block_symbols && rmt_chan_config.mem_block_symbols != LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS) {
+        // the extra memory block may be taken by others, fall back to a single memory block
+        ESP_LOGW(TAG, "can't allocate %d RMT symbols%s, fall back to the default size", (int)rmt_chan_config.mem_block_symbols,
+                 rmt_chan_config.flags.with_dma ? " with DMA" : "");
+        rmt_chan_config.mem_block_symbols = LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS;
+        ret = rmt_new_tx_channel(&rmt_chan_config, &rmt_strip->rmt_chan);
+    }
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "create RMT TX channel failed");
+    led_strip_rmt_set_chan_config(rmt_strip, &rmt_chan_config);
+
+    rmt_tx_event_callbacks_t cbs = {
+        .on_trans_done = led_strip_rmt_on_trans_done,
+    };
+    ESP_GOTO_ON_ERROR(rmt_tx_register_event_callbacks(rmt_strip->rmt_chan, &cbs, rmt_strip), err, TAG, "register RMT event callbacks failed");
+    if (rmt_config->flags.double_buffer) {
+        // keep the channel enabled between frames, so an asynchronous refresh doesn't pay for enabling it again
+        ESP_GOTO_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), err, TAG, "enable RMT channel failed");
+        rmt_strip->front_buf = rmt_strip->pixel_buf + rmt_strip->strip_len * rmt_strip->bytes_per_pixel;
+    }
+
+    *ret_strip = &rmt_strip->base;
+    return ESP_OK;
+err:
+    if (rmt_strip) {
+        if (rmt_strip->rmt_chan) {
+            if (rmt_strip->front_buf) {
+                rmt_disable(rmt_strip->rmt_chan);
+            }
+            rmt_del_channel(rmt_strip->rmt_chan);
+        }
+        led_strip_rmt_free_obj(rmt_strip);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_rmt_get_stats(led_strip_handle_t strip, led_strip_rmt_stats_t *ret_stats)
+{
+    ESP_RETURN_ON_FALSE(strip && ret_stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->refresh == led_strip_rmt_refresh || strip->refresh == led_strip_rmt_pool_strip_refresh, ESP_ERR_INVALID_ARG, TAG,
+                        "strip is not RMT based");
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    *ret_stats = rmt_strip->stats;
+    // frame rate since the last report
+    int64_t now_us = esp_timer_get_time();
+    if (now_us > rmt_strip->fps_since_us) {
+        ret_stats->fps = (float)(ret_stats->frames - rmt_strip->fps_frames) * 1000000 / (now_us - rmt_strip->fps_since_us);
+    }
+    rmt_strip->fps_frames = ret_stats->frames;
+    rmt_strip->fps_since_us = now_us;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_rmt_group(const led_strip_handle_t *strips, size_t num_strips, led_strip_rmt_group_handle_t *ret_group)
+{
+    esp_err_t ret = ESP_OK;
+    led_strip_rmt_group_handle_t group = NULL;
+    rmt_channel_handle_t *channels = NULL;
+    ESP_RETURN_ON_FALSE(strips && num_strips && ret_group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    for (size_t i = 0; i < num_strips; i++) {
+        ESP_RETURN_ON_FALSE(strips[i] && strips[i]->refresh == led_strip_rmt_refresh, ESP_ERR_INVALID_ARG, TAG, "strip %d is not RMT based", (int)i);
+        led_strip_rmt_obj *rmt_strip = __containerof(strips[i], led_strip_rmt_obj, base);
+        ESP_RETURN_ON_FALSE(!rmt_strip->grouped, ESP_ERR_INVALID_ARG, TAG, "strip %d is already grouped", (int)i);
+    }
+    group = calloc(1, sizeof(struct led_strip_rmt_group_t) + num_strips * sizeof(led_strip_rmt_obj *));
+    channels = calloc(num_strips, sizeof(rmt_channel_handle_t));
+    ESP_GOTO_ON_FALSE(group && channels, ESP_ERR_NO_MEM, err, TAG, "no mem for strip group");
+    group->num_strips = num_strips;
+    for (size_t i = 0; i < num_strips; i++) {
+        group->strips[i] = __containerof(strips[i], led_strip_rmt_obj, base);
+        channels[i] = group->strips[i]->rmt_chan;
+        // the sync manager can only be installed on channels that are not enabled yet
+        if (group->strips[i]->front_buf) {
+            ESP_GOTO_ON_ERROR(rmt_tx_wait_all_done(channels[i], -1), err, TAG, "flush RMT channel failed");
+            ESP_GOTO_ON_ERROR(rmt_disable(channels[i]), err, TAG, "disable RMT channel failed");
+        }
+    }
+    rmt_sync_manager_config_t synchro_config = {
+        .tx_channel_array = channels,
+        .array_size = num_strips,
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_sync_manager(&synchro_config, &group->synchro), err, TAG, "create RMT sync manager failed");
+    // keep the channels enabled while grouped, a transmission starts once all the channels in the group have one queued
+    for (size_t i = 0; i < num_strips; i++) {
+        ESP_GOTO_ON_ERROR(rmt_enable(channels[i]), err, TAG, "enable RMT channel failed");
+        group->strips[i]->grouped = true;
+    }
+    free(channels);
+    *ret_group = group;
+    return ESP_OK;
+err:
+    if (group) {
+        for (size_t i = 0; i < num_strips && group->strips[i]; i++) {
+            if (group->strips[i]->grouped) {
+                rmt_disable(group->strips[i]->rmt_chan);
+                group->strips[i]->grouped = false;
+            }
+        }
+        if (group->synchro) {
+            rmt_del_sync_manager(group->synchro);
+        }
+        for (size_t i = 0; i < num_strips && group->strips[i]; i++) {
+            if (group->strips[i]->front_buf) {
+                rmt_enable(group->strips[i]->rmt_chan);
+            }
+        }
+        free(group);
+    }
+    free(channels);
+    return ret;
+}
+
+esp_err_t led_strip_rmt_group_refresh(led_strip_rmt_group_handle_t group)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    for (size_t i = 0; i < group->num_strips; i++) {
+        led_strip_rmt_obj *rmt_strip = group->strips[i];
+        ESP_RETURN_ON_ERROR(led_strip_rmt_transmit(rmt_strip, rmt_strip->pixel_buf), TAG, "transmit pixels by RMT failed");
+    }
+    // the strips run in parallel, so waiting for them in turn only takes as long as the longest strip
+    for (size_t i = 0; i < group->num_strips; i++) {
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(group->strips[i]->rmt_chan, -1), TAG, "flush RMT channel failed");
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_del_rmt_group(led_strip_rmt_group_handle_t group)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    for (size_t i = 0; i < group->num_strips; i++) {
+        led_strip_rmt_obj *rmt_strip = group->strips[i];
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+        ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), TAG, "disable RMT channel failed");
+    }
+    ESP_RETURN_ON_ERROR(rmt_del_sync_manager(group->synchro), TAG, "delete RMT sync manager failed");
+    for (size_t i = 0; i < group->num_strips; i++) {
+        led_strip_rmt_obj *rmt_strip = group->strips[i];
+        rmt_strip->grouped = false;
+        // restore the channel state of the double buffer mode
+        if (rmt_strip->front_buf) {
+            ESP_RETURN_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), TAG, "enable RMT channel failed");
+        }
+    }
+    free(group);
+    return ESP_OK;
+}
+
+// park the GPIO of a strip that has no RMT channel at the idle level, so the LEDs don't pick up noise
+static esp_err_t led_strip_rmt_pool_park_gpio(led_strip_rmt_obj *rmt_strip)
+{
+    ESP_RETURN_ON_ERROR(gpio_set_level(rmt_strip->gpio_num, rmt_strip->invert_out ? 1 : 0), TAG, "set GPIO level failed");
+    return gpio_set_direction(rmt_strip->gpio_num, GPIO_MODE_OUTPUT);
+}
+
+// release the channel of a pool slot, the strip that owned it goes back to the parked GPIO
+static esp_err_t led_strip_rmt_pool_release(led_strip_rmt_pool_slot_t *slot)
+{
+    if (slot->chan) {
+        ESP_RETURN_ON_ERROR(rmt_disable(slot->chan), TAG, "disable RMT channel failed");
+        ESP_RETURN_ON_ERROR(rmt_del_channel(slot->chan), TAG, "delete RMT channel failed");
+        slot->chan = NULL;
+    }
+    if (slot->owner) {
+        slot->owner->rmt_chan = NULL;
+        ESP_RETURN_ON_ERROR(led_strip_rmt_pool_park_gpio(slot->owner), TAG, "park GPIO failed");
+        slot->owner = NULL;
+    }
+    return ESP_OK;
+}
+
+// route a pool slot to the strip, the RMT driver can't move a channel to another GPIO, so the channel is created again on the GPIO of the strip
+static esp_err_t led_strip_rmt_pool_attach(led_strip_rmt_pool_handle_t pool, led_strip_rmt_pool_slot_t *slot, led_strip_rmt_obj *rmt_strip)
+{
+    esp_err_t ret = ESP_OK;
+    if (slot->owner == rmt_strip) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(led_strip_rmt_pool_release(slot), TAG, "release RMT channel failed");
+    rmt_tx_channel_config_t chan_config = pool->chan_config;
+    chan_config.gpio_num = rmt_strip->gpio_num;
+    chan_config.flags.invert_out = rmt_strip->invert_out;
+    ESP_GOTO_ON_ERROR(rmt_new_tx_channel(&chan_config, &slot->chan), err, TAG, "create RMT TX channel failed");
+    rmt_tx_event_callbacks_t cbs = {
+        .on_trans_done = led_strip_rmt_on_trans_done,
+    };
+    ESP_GOTO_ON_ERROR(rmt_tx_register_event_callbacks(slot->chan, &cbs, rmt_strip), err, TAG, "register RMT event callbacks failed");
+    ESP_GOTO_ON_ERROR(rmt_enable(slot->chan), err, TAG, "enable RMT channel failed");
+    slot->owner = rmt_strip;
+    rmt_strip->rmt_chan = slot->chan;
+    rmt_strip->stats.channel_switches++;
+    return ESP_OK;
+err:
+    if (slot->chan) {
+        rmt_del_channel(slot->chan);
+        slot->chan = NULL;
+    }
+    return ret;
+}
+
+// pick a slot that is not busy for the strip: the one it already owns, a free one, or the next one in turn
+static led_strip_rmt_pool_slot_t *led_strip_rmt_pool_pick_slot(led_strip_rmt_pool_handle_t pool, led_strip_rmt_obj *rmt_strip)
+{
+    led_strip_rmt_pool_slot_t *free_slot = NULL;
+    for (size_t i = 0; i < pool->num_slots; i++) {
+        led_strip_rmt_pool_slot_t *slot = &pool->slots[i];
+        if (slot->busy) {
+            continue;
+        }
+        if (slot->owner == rmt_strip) {
+            return slot;
+        }
+        if (!slot->owner && !free_slot) {
+            free_slot = slot;
+        }
+    }
+    if (free_slot) {
+        return free_slot;
+    }
+    for (size_t i = 0; i < pool->num_slots; i++) {
+        led_strip_rmt_pool_slot_t *slot = &pool->slots[pool->next_victim];
+        pool->next_victim = (pool->next_victim + 1) % pool->num_slots;
+        if (!slot->busy) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+static esp_err_t led_strip_rmt_pool_strip_refresh(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    led_strip_rmt_pool_handle_t pool = rmt_strip->pool;
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    led_strip_rmt_pool_slot_t *slot = led_strip_rmt_pool_pick_slot(pool, rmt_strip);
+    ESP_GOTO_ON_ERROR(led_strip_rmt_pool_attach(pool, slot, rmt_strip), out, TAG, "attach RMT channel failed");
+    ESP_GOTO_ON_ERROR(led_strip_rmt_transmit(rmt_strip, rmt_strip->pixel_buf), out, TAG, "transmit pixels by RMT failed");
+    ESP_GOTO_ON_ERROR(rmt_tx_wait_all_done(slot->chan, -1), out, TAG, "flush RMT channel failed");
+out:
+    xSemaphoreGive(pool->lock);
+    return ret;
+}
+
+static esp_err_t led_strip_rmt_pool_strip_del(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    led_strip_rmt_pool_handle_t pool = rmt_strip->pool;
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    for (size_t i = 0; i < pool->num_slots; i++) {
+        if (pool->slots[i].owner == rmt_strip) {
+            ESP_GOTO_ON_ERROR(led_strip_rmt_pool_release(&pool->slots[i]), out, TAG, "release RMT channel failed");
+        }
+    }
+    for (size_t i = 0; i < pool->num_strips; i++) {
+        if (pool->strips[i] == rmt_strip) {
+            memmove(&pool->strips[i], &pool->strips[i + 1], (pool->num_strips - i - 1) * sizeof(led_strip_rmt_obj *));
+            pool->num_strips--;
+            break;
+        }
+    }
+    pool->next_strip = pool->num_strips ? pool->next_strip % pool->num_strips : 0;
+out:
+    xSemaphoreGive(pool->lock);
+    ESP_RETURN_ON_ERROR(ret, TAG, "remove strip from pool failed");
+    ESP_RETURN_ON_ERROR(rmt_del_encoder(rmt_strip->strip_encoder), TAG, "delete strip encoder failed");
+    free(rmt_strip->ext_buffers);
+    free(rmt_strip);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_rmt_pool(const led_strip_rmt_pool_config_t *config, led_strip_rmt_pool_handle_t *ret_pool)
+{
+    esp_err_t ret = ESP_OK;
+    led_strip_rmt_pool_handle_t pool = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_pool, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->num_channels && config->num_channels <= SOC_RMT_TX_CANDIDATES_PER_GROUP, ESP_ERR_INVALID_ARG, err, TAG, "invalid number of channels");
+    ESP_GOTO_ON_FALSE(config->color_order < LED_COLOR_ORDER_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid color order");
+    pool = calloc(1, sizeof(struct led_strip_rmt_pool_t) + config->num_channels * sizeof(led_strip_rmt_pool_slot_t));
+    ESP_GOTO_ON_FALSE(pool, ESP_ERR_NO_MEM, err, TAG, "no mem for strip pool");
+    pool->lock = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(pool->lock, ESP_ERR_NO_MEM, err, TAG, "no mem for pool lock");
+    pool->num_slots = config->num_channels;
+    pool->color_order = config->color_order;
+    pool->frame_budget_us = config->frame_budget_us;
+    // the channels are created on demand, when a strip is routed to them
+    pool->chan_config = (rmt_tx_channel_config_t) {
+        .clk_src = config->clk_src ? config->clk_src : RMT_CLK_SRC_DEFAULT,
+        .gpio_num = -1,
+        .mem_block_symbols = config->mem_block_symbols ? config->mem_block_symbols : LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS,
+        .resolution_hz = config->resolution_hz ? config->resolution_hz : LED_STRIP_RMT_DEFAULT_RESOLUTION,
+        .trans_queue_depth = 1,
+    };
+    *ret_pool = pool;
+    return ESP_OK;
+err:
+    if (pool) {
+        if (pool->lock) {
+            vSemaphoreDelete(pool->lock);
+        }
+        free(pool);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_new_rmt_pool_device(led_strip_rmt_pool_handle_t pool, const led_strip_config_t *led_config, led_strip_handle_t *ret_strip)
+{
+    led_strip_rmt_obj *rmt_strip = NULL;
+    ESP_RETURN_ON_FALSE(pool && led_config && ret_strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_ERROR(led_strip_rmt_new_obj(led_config, pool->chan_config.resolution_hz, pool->color_order, false, &rmt_strip),
+                        TAG, "create LED strip object failed");
+    rmt_strip->pool = pool;
+    rmt_strip->gpio_num = led_config->strip_gpio_num;
+    rmt_strip->invert_out = led_config->flags.invert_out;
+    led_strip_rmt_set_chan_config(rmt_strip, &pool->chan_config);
+    rmt_strip->base.refresh = led_strip_rmt_pool_strip_refresh;
+    // a pool strip borrows a channel only for the time of its own frame
+    rmt_strip->base.refresh_async = NULL;
+    rmt_strip->base.wait_refresh_done = NULL;
+    rmt_strip->base.del = led_strip_rmt_pool_strip_del;
+
+    esp_err_t ret = led_strip_rmt_pool_park_gpio(rmt_strip);
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    if (ret == ESP_OK && pool->num_strips < LED_STRIP_RMT_POOL_MAX_STRIPS) {
+        pool->strips[pool->num_strips++] = rmt_strip;
+    } else if (ret == ESP_OK) {
+        ret = ESP_ERR_NO_MEM;
+    }
+    xSemaphoreGive(pool->lock);
+    if (ret != ESP_OK) {
+        led_strip_rmt_free_obj(rmt_strip);
+        ESP_RETURN_ON_ERROR(ret, TAG, "add strip to pool failed");
+    }
+    *ret_strip = &rmt_strip->base;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_rmt_pool_refresh(led_strip_rmt_pool_handle_t pool)
+{
+    ESP_RETURN_ON_FALSE(pool, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    esp_err_t ret = ESP_OK;
+    led_strip_rmt_pool_slot_t *wave_slots[SOC_RMT_TX_CANDIDATES_PER_GROUP] = {};
+    size_t wave_size = 0;
+    size_t sent = 0;
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    int64_t start_us = esp_timer_get_time();
+    // send the strips in waves of one strip per channel, starting from the first strip that the last refresh left out
+    while (sent < pool->num_strips) {
+        wave_size = pool->num_strips - sent < pool->num_slots ? pool->num_strips - sent : pool->num_slots;
+        uint32_t wave_us = 0;
+        for (size_t i = 0; i < wave_size; i++) {
+            led_strip_rmt_obj *rmt_strip = pool->strips[(pool->next_strip + i) % pool->num_strips];
+            uint32_t len = rmt_strip->sent_len > rmt_strip->active_len ? rmt_strip->sent_len : rmt_strip->active_len;
+            uint32_t frame_us = led_strip_rmt_wire_us(rmt_strip, len * rmt_strip->bytes_per_pixel);
+            wave_us = frame_us > wave_us ? frame_us : wave_us;
+        }
+        // at least one wave goes out, so every strip gets its turn
+        if (sent && pool->frame_budget_us && esp_timer_get_time() - start_us + wave_us > pool->frame_budget_us) {
+            break;
+        }
+        // the strips that still own a channel keep it, the others take over the remaining ones
+        for (size_t i = 0; i < wave_size; i++) {
+            led_strip_rmt_obj *rmt_strip = pool->strips[(pool->next_strip + i) % pool->num_strips];
+            wave_slots[i] = NULL;
+            for (size_t j = 0; j < pool->num_slots; j++) {
+                if (pool->slots[j].owner == rmt_strip) {
+                    wave_slots[i] = &pool->slots[j];
+                    wave_slots[i]->busy = true;
+                }
+            }
+        }
+        for (size_t i = 0; i < wave_size; i++) {
+            led_strip_rmt_obj *rmt_strip = pool->strips[(pool->next_strip + i) % pool->num_strips];
+            if (!wave_slots[i]) {
+                wave_slots[i] = led_strip_rmt_pool_pick_slot(pool, rmt_strip);
+                wave_slots[i]->busy = true;
+            }
+            ESP_GOTO_ON_ERROR(led_strip_rmt_pool_attach(pool, wave_slots[i], rmt_strip), out, TAG, "attach RMT channel failed");
+            ESP_GOTO_ON_ERROR(led_strip_rmt_transmit(rmt_strip, rmt_strip->pixel_buf), out, TAG, "transmit pixels by RMT failed");
+        }
+        // the channels run in parallel, so the wave takes as long as its longest strip
+        for (size_t i = 0; i < wave_size; i++) {
+            ESP_GOTO_ON_ERROR(rmt_tx_wait_all_done(wave_slots[i]->chan, -1), out, TAG, "flush RMT channel failed");
+            wave_slots[i]->busy = false;
+        }
+        sent += wave_size;
+        pool->next_strip = (pool->next_strip + wave_size) % pool->num_strips;
+    }
+    for (size_t i = sent; i < pool->num_strips; i++) {
+        pool->strips[(pool->next_strip + i - sent) % pool->num_strips]->stats.deferred++;
+    }
+out:
+    for (size_t i = 0; i < pool->num_slots; i++) {
+        if (pool->slots[i].busy && pool->slots[i].chan) {
+            rmt_tx_wait_all_done(pool->slots[i].chan, -1);
+        }
+        pool->slots[i].busy = false;
+    }
+    xSemaphoreGive(pool->lock);
+    return ret;
+}
+
+esp_err_t led_strip_del_rmt_pool(led_strip_rmt_pool_handle_t pool)
+{
+    ESP_RETURN_ON_FALSE(pool, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(pool->num_strips == 0, ESP_ERR_INVALID_STATE, TAG, "delete the strips of the pool first");
+    for (size_t i = 0; i < pool->num_slots; i++) {
+        ESP_RETURN_ON_ERROR(led_strip_rmt_pool_release(&pool->slots[i]), TAG, "release RMT channel failed");
+    }
+    vSemaphoreDelete(pool->lock);
+    free(pool);
+    return ESP_OK;
+}
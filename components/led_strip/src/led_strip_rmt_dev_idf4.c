@@ -0,0 +1,267 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/rmt.h"
+#include "esp_rom_sys.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_timing.h"
+#include "led_strip_encoding.h"
+
+static const char *TAG = "led_strip_rmt";
+
+// the memory size of each RMT channel, in words (4 bytes)
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS 64
+#else
+#define LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS 48
+#endif
+
+typedef struct {
+    led_strip_t base;
+    rmt_channel_t rmt_channel;
+    uint32_t strip_len;
+    uint32_t active_len;   // number of leading pixels sent by a refresh
+    uint32_t sent_len;     // number of pixels sent by the last frame, the ones beyond the active length need to be blanked once
+    uint8_t bytes_per_pixel;
+    uint32_t reset_us;    // low time that latches the frame
+    int64_t latch_end_us; // esp_timer time when the LEDs have latched the last frame
+    uint32_t nibble_symbols[16][4]; // RMT items of every 4-bit value (MSB first), with the timing of this strip's LED model
+    uint8_t *buffer;  // either the caller-owned pixel buffer or the storage below
+    const uint8_t *blank_start; // the adapter sends the bytes from here on as zeros, the end of the active pixels
+    uint8_t storage[0];
+} led_strip_rmt_obj;
+
+static void IRAM_ATTR ws2812_rmt_adapter(const void *src, rmt_item32_t *dest, size_t src_size,
+        size_t wanted_num, size_t *translated_size, size_t *item_num)
+{
+    if (src == NULL || dest == NULL) {
+        *translated_size = 0;
+        *item_num = 0;
+        return;
+    }
+    led_strip_rmt_obj *rmt_strip = NULL;
+    rmt_translator_get_context(item_num, (void **)&rmt_strip);
+    size_t size = 0;
+    size_t num = 0;
+    const uint8_t *psrc = (const uint8_t *)src;
+    rmt_item32_t *pdest = dest;
+    while (size < src_size && num < wanted_num) {
+        // one byte takes two table lookups, high nibble first
+        uint8_t data = psrc < rmt_strip->blank_start ? *psrc : 0;
+        led_strip_encode_byte_symbols(rmt_strip->nibble_symbols, data, &pdest->val);
+        num += 8;
+        pdest += 8;
+        size++;
+        psrc++;
+    }
+    *translated_size = size;
+    *item_num = num;
+}
+
+static esp_err_t led_strip_rmt_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(index < rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of the maximum number of leds");
+    uint32_t start = index * rmt_strip->bytes_per_pixel;
+    // In thr order of GRB
+    rmt_strip->buffer[start + 0] = green & 0xFF;
+    rmt_strip->buffer[start + 1] = red & 0xFF;
+    rmt_strip->buffer[start + 2] = blue & 0xFF;
+    if (rmt_strip->bytes_per_pixel > 3) {
+        rmt_strip->buffer[start + 3] = 0;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(start <= rmt_strip->strip_len && count <= rmt_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint8_t bytes_per_pixel = rmt_strip->bytes_per_pixel;
+    uint8_t *buf = rmt_strip->buffer + start * bytes_per_pixel;
+    for (uint32_t i = 0; i < count; i++) {
+        // In the order of GRB
+        buf[0] = rgb[1];
+        buf[1] = rgb[0];
+        buf[2] = rgb[2];
+        if (bytes_per_pixel > 3) {
+            buf[3] = 0;
+        }
+        buf += bytes_per_pixel;
+        rgb += 3;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_fill(led_strip_t *strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(start <= rmt_strip->strip_len && count <= rmt_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint8_t bytes_per_pixel = rmt_strip->bytes_per_pixel;
+    const uint8_t pixel[4] = {green & 0xFF, red & 0xFF, blue & 0xFF, 0};
+    uint8_t *buf = rmt_strip->buffer + start * bytes_per_pixel;
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(buf, pixel, bytes_per_pixel);
+        buf += bytes_per_pixel;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_write_frame(led_strip_t *strip, const uint8_t *frame, size_t size)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(size % rmt_strip->bytes_per_pixel == 0 && size <= rmt_strip->strip_len * rmt_strip->bytes_per_pixel, ESP_ERR_INVALID_ARG, TAG,
+                        "frame size doesn't fit the LED strip");
+    memcpy(rmt_strip->buffer, frame, size);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_get_buffer(led_strip_t *strip, uint8_t **ret_buf, size_t *ret_size)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    *ret_buf = rmt_strip->buffer;
+    *ret_size = rmt_strip->strip_len * rmt_strip->bytes_per_pixel;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_active_length(led_strip_t *strip, uint32_t length)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(length && length <= rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "active length out of maximum number of LEDs");
+    rmt_strip->active_len = length;
+    return ESP_OK;
+}
+
+// the line stays low after a frame until the LEDs latch it, the next frame must not start earlier
+static void led_strip_rmt_wait_latch(led_strip_rmt_obj *rmt_strip)
+{
+    int64_t wait_us = rmt_strip->latch_end_us - esp_timer_get_time();
+    if (wait_us >= portTICK_PERIOD_MS * 1000) {
+        // block instead of spinning, the extra tick covers the part of the current tick that has already passed
+        vTaskDelay(wait_us / (portTICK_PERIOD_MS * 1000) + 1);
+    } else if (wait_us > 0) {
+        esp_rom_delay_us(wait_us);
+    }
+}
+
+static esp_err_t led_strip_rmt_refresh(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    led_strip_rmt_wait_latch(rmt_strip);
+    // the pixels that the last frame lit beyond the active length are sent as zeros by the adapter, the buffer stays untouched
+    uint32_t len = rmt_strip->sent_len > rmt_strip->active_len ? rmt_strip->sent_len : rmt_strip->active_len;
+    rmt_strip->blank_start = rmt_strip->buffer + rmt_strip->active_len * rmt_strip->bytes_per_pixel;
+    ESP_RETURN_ON_ERROR(rmt_write_sample(rmt_strip->rmt_channel, rmt_strip->buffer, len * rmt_strip->bytes_per_pixel, true), TAG,
+                        "transmit RMT samples failed");
+    rmt_strip->sent_len = rmt_strip->active_len;
+    // the samples are sent, the LEDs latch them while the caller draws the next frame
+    rmt_strip->latch_end_us = esp_timer_get_time() + rmt_strip->reset_us;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_clear(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    // Write zero to turn off all LEDs
+    memset(rmt_strip->buffer, 0, rmt_strip->strip_len * rmt_strip->bytes_per_pixel);
+    return led_strip_rmt_refresh(strip);
+}
+
+static esp_err_t led_strip_rmt_del(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_ERROR(rmt_driver_uninstall(rmt_strip->rmt_channel), TAG, "uninstall RMT driver failed");
+    free(rmt_strip);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *dev_config, led_strip_handle_t *ret_strip)
+{
+    led_strip_rmt_obj *rmt_strip = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(led_config && dev_config && ret_strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(led_config->led_pixel_format < LED_PIXEL_FORMAT_INVALID, ESP_ERR_INVALID_ARG, TAG, "invalid led_pixel_format");
+    ESP_RETURN_ON_FALSE(led_strip_get_timing(led_config->led_model), ESP_ERR_INVALID_ARG, TAG, "invalid led_model");
+    ESP_RETURN_ON_FALSE(dev_config->flags.with_dma == 0, ESP_ERR_NOT_SUPPORTED, TAG, "DMA is not supported");
+    ESP_RETURN_ON_FALSE(led_config->flags.pixel_buf_in_psram == 0, ESP_ERR_NOT_SUPPORTED, TAG, "PSRAM pixel buffer is not supported");
+    ESP_RETURN_ON_FALSE(dev_config->flags.double_buffer == 0, ESP_ERR_NOT_SUPPORTED, TAG, "double buffer is not supported");
+
+    uint8_t bytes_per_pixel = 3;
+    if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRBW) {
+        bytes_per_pixel = 4;
+    } else if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRB) {
+        bytes_per_pixel = 3;
+    } else {
+        assert(false);
+    }
+
+    // allocate memory for led_strip object
+    size_t storage_size = led_config->pixel_buf ? 0 : led_config->max_leds * bytes_per_pixel;
+    rmt_strip = calloc(1, sizeof(led_strip_rmt_obj) + storage_size);
+    ESP_RETURN_ON_FALSE(rmt_strip, ESP_ERR_NO_MEM, TAG, "request memory for les_strip failed");
+    rmt_strip->buffer = led_config->pixel_buf ? led_config->pixel_buf : rmt_strip->storage;
+
+    // install RMT channel driver
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX(led_config->strip_gpio_num, dev_config->rmt_channel);
+    // set the minimal clock division because the LED strip needs a high clock resolution
+    config.clk_div = 2;
+
+    uint8_t mem_block_num = 2;
+    // override the default value if the user specify the mem block size
+    if (dev_config->mem_block_symbols) {
+        mem_block_num = (dev_config->mem_block_symbols + LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS / 2) / LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS;
+    }
+    config.mem_block_num = mem_block_num;
+
+    ESP_GOTO_ON_ERROR(rmt_config(&config), err, TAG, "RMT config failed");
+    ESP_GOTO_ON_ERROR(rmt_driver_install(config.channel, 0, 0), err, TAG, "RMT install failed");
+
+    uint32_t counter_clk_hz = 0;
+    rmt_get_counter_clock((rmt_channel_t)dev_config->rmt_channel, &counter_clk_hz);
+    const led_strip_timing_t *timing = led_strip_get_timing(led_config->led_model);
+    rmt_strip->reset_us = led_config->reset_us ? led_config->reset_us : timing->reset_us;
+    // same nibble table as the capture backend, which the host tests check against the former bit by bit adapter
+    uint32_t bit0 = 0;
+    uint32_t bit1 = 0;
+    led_strip_get_bit_symbols(timing, counter_clk_hz, &bit0, &bit1);
+    led_strip_build_nibble_symbols(bit0, bit1, rmt_strip->nibble_symbols);
+
+    // adapter to translates the LES strip date frame into RMT symbols, the timing table is passed as the translator context
+    rmt_translator_init((rmt_channel_t)dev_config->rmt_channel, ws2812_rmt_adapter);
+    rmt_translator_set_context((rmt_channel_t)dev_config->rmt_channel, rmt_strip);
+
+    rmt_strip->bytes_per_pixel = bytes_per_pixel;
+    rmt_strip->rmt_channel = (rmt_channel_t)dev_config->rmt_channel;
+    rmt_strip->strip_len = led_config->max_leds;
+    rmt_strip->active_len = led_config->max_leds;
+    rmt_strip->sent_len = led_config->max_leds;
+    rmt_strip->base.set_pixel = led_strip_rmt_set_pixel;
+    rmt_strip->base.set_pixels = led_strip_rmt_set_pixels;
+    rmt_strip->base.fill = led_strip_rmt_fill;
+    rmt_strip->base.write_frame = led_strip_rmt_write_frame;
+    rmt_strip->base.get_buffer = led_strip_rmt_get_buffer;
+    rmt_strip->base.set_active_length = led_strip_rmt_set_active_length;
+    rmt_strip->base.refresh = led_strip_rmt_refresh;
+    rmt_strip->base.clear = led_strip_rmt_clear;
+    rmt_strip->base.del = led_strip_rmt_del;
+
+    *ret_strip = &rmt_strip->base;
+    return ESP_OK;
+
+err:
+    if (rmt_strip) {
+        free(rmt_strip);
+    }
+    return ret;
+}
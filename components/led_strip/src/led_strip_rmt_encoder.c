@@ -0,0 +1,218 @@
+/*
+ * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "esp_check.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "led_strip_rmt_encoder.h"
+#include "led_strip_timing.h"
+#include "led_strip_encoding.h"
+
+static const char *TAG = "led_rmt_encoder";
+
+typedef struct {
+    rmt_encoder_t base;
+    rmt_encoder_t *bytes_encoder;
+    rmt_encoder_t *copy_encoder;
+    int state;
+    uint32_t encode_calls; // number of encode calls since the transaction started
+    rmt_symbol_word_t reset_code;
+    uint8_t bytes_per_pixel;
+    led_strip_transform_t transform; // color order, gamma correction and brightness, shared with the capture backend
+    led_strip_transform_t staged;    // transform set by the user, taken over at the start of the next frame
+    bool staged_pending;   // whether the staged transform differs from the one in use
+    bool frame_started;    // whether the transform of the current frame is already taken
+    portMUX_TYPE lock;     // protects the staged transform
+    bool pixel_pending;    // whether the transformed pixel is only partially encoded
+    uint32_t pixel_index;  // index of the pixel being encoded by the transform stage
+    uint32_t blank_from;   // pixels from this index on are sent out as zeros, whatever the source holds
+    uint8_t pixel[4];      // transformed pixel being encoded
+} rmt_led_strip_encoder_t;
+
+static size_t rmt_encode_led_strip(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primary_data, size_t data_size, rmt_encode_state_t *ret_state)
+{
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    rmt_encoder_handle_t bytes_encoder = led_encoder->bytes_encoder;
+    rmt_encoder_handle_t copy_encoder = led_encoder->copy_encoder;
+    rmt_encode_state_t session_state = 0;
+    rmt_encode_state_t state = 0;
+    size_t encoded_symbols = 0;
+    led_encoder->encode_calls++;
+    switch (led_encoder->state) {
+    case 0: // send RGB data
+        if (!led_encoder->frame_started) {
+            // the frame may be encoded from the TX interrupt, a new brightness or gamma table only takes effect from the next frame on
+            portENTER_CRITICAL_SAFE(&led_encoder->lock);
+            if (led_encoder->staged_pending) {
+                led_encoder->transform = led_encoder->staged;
+                led_encoder->staged_pending = false;
+            }
+            portEXIT_CRITICAL_SAFE(&led_encoder->lock);
+            led_encoder->frame_started = true;
+        }
+        if (!led_encoder->transform.active && led_encoder->blank_from >= data_size / led_encoder->bytes_per_pixel) {
+            encoded_symbols += bytes_encoder->encode(bytes_encoder, channel, primary_data, data_size, &session_state);
+            if (session_state & RMT_ENCODING_COMPLETE) {
+                led_encoder->state = 1; // switch to next state when current encoding session finished
+            }
+            if (session_state & RMT_ENCODING_MEM_FULL) {
+                state |= RMT_ENCODING_MEM_FULL;
+                goto out; // yield if there's no free space for encoding artifacts
+            }
+        } else {
+            // transform the pixels one by one, the bytes encoder keeps its progress within a pixel across calls
+            const uint8_t *pixels = (const uint8_t *)primary_data;
+            uint8_t bytes_per_pixel = led_encoder->bytes_per_pixel;
+            uint32_t num_pixels = data_size / bytes_per_pixel;
+            while (led_encoder->pixel_index < num_pixels) {
+                if (!led_encoder->pixel_pending) {
+                    const uint8_t *src = pixels + led_encoder->pixel_index * bytes_per_pixel;
+                    if (led_encoder->pixel_index >= led_encoder->blank_from) {
+                        memset(led_encoder->pixel, 0, sizeof(led_encoder->pixel));
+                    } else {
+                        led_strip_transform_pixel(&led_encoder->transform, src, led_encoder->pixel, bytes_per_pixel);
+                    }
+                    led_encoder->pixel_pending = true;
+                }
+                encoded_symbols += bytes_encoder->encode(bytes_encoder, channel, led_encoder->pixel, bytes_per_pixel, &session_state);
+                if (session_state & RMT_ENCODING_COMPLETE) {
+                    led_encoder->pixel_pending = false;
+                    led_encoder->pixel_index++;
+                }
+                if (session_state & RMT_ENCODING_MEM_FULL) {
+                    state |= RMT_ENCODING_MEM_FULL;
+                    goto out; // yield if there's no free space for encoding artifacts
+                }
+            }
+            led_encoder->pixel_index = 0;
+            led_encoder->state = 1; // switch to next state when all the pixels are encoded
+        }
+    // fall-through
+    case 1: // send reset code
+        encoded_symbols += copy_encoder->encode(copy_encoder, channel, &led_encoder->reset_code,
+                                                sizeof(led_encoder->reset_code), &session_state);
+        if (session_state & RMT_ENCODING_COMPLETE) {
+            led_encoder->state = 0; // back to the initial encoding session
+            led_encoder->frame_started = false;
+            state |= RMT_ENCODING_COMPLETE;
+        }
+        if (session_state & RMT_ENCODING_MEM_FULL) {
+            state |= RMT_ENCODING_MEM_FULL;
+            goto out; // yield if there's no free space for encoding artifacts
+        }
+    }
+out:
+    *ret_state = state;
+    return encoded_symbols;
+}
+
+static esp_err_t rmt_del_led_strip_encoder(rmt_encoder_t *encoder)
+{
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    rmt_del_encoder(led_encoder->bytes_encoder);
+    rmt_del_encoder(led_encoder->copy_encoder);
+    free(led_encoder);
+    return ESP_OK;
+}
+
+static esp_err_t rmt_led_strip_encoder_reset(rmt_encoder_t *encoder)
+{
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    rmt_encoder_reset(led_encoder->bytes_encoder);
+    rmt_encoder_reset(led_encoder->copy_encoder);
+    led_encoder->state = 0;
+    led_encoder->encode_calls = 0;
+    led_encoder->pixel_index = 0;
+    led_encoder->pixel_pending = false;
+    led_encoder->frame_started = false;
+    return ESP_OK;
+}
+
+esp_err_t rmt_led_strip_encoder_set_brightness(rmt_encoder_handle_t encoder, uint8_t brightness)
+{
+    ESP_RETURN_ON_FALSE(encoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    portENTER_CRITICAL(&led_encoder->lock);
+    led_strip_transform_set_brightness(&led_encoder->staged, brightness);
+    led_encoder->staged_pending = true;
+    portEXIT_CRITICAL(&led_encoder->lock);
+    return ESP_OK;
+}
+
+esp_err_t rmt_led_strip_encoder_set_gamma_table(rmt_encoder_handle_t encoder, const uint8_t *gamma_table)
+{
+    ESP_RETURN_ON_FALSE(encoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    portENTER_CRITICAL(&led_encoder->lock);
+    led_strip_transform_set_gamma_table(&led_encoder->staged, gamma_table);
+    led_encoder->staged_pending = true;
+    portEXIT_CRITICAL(&led_encoder->lock);
+    return ESP_OK;
+}
+
+esp_err_t rmt_led_strip_encoder_set_blank_from(rmt_encoder_handle_t encoder, uint32_t first_pixel)
+{
+    ESP_RETURN_ON_FALSE(encoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    led_encoder->blank_from = first_pixel;
+    return ESP_OK;
+}
+
+uint32_t IRAM_ATTR rmt_led_strip_encoder_get_encode_calls(rmt_encoder_handle_t encoder)
+{
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    return led_encoder->encode_calls;
+}
+
+esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+{
+    esp_err_t ret = ESP_OK;
+    rmt_led_strip_encoder_t *led_encoder = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_encoder, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    const led_strip_timing_t *timing = led_strip_get_timing(config->led_model);
+    ESP_GOTO_ON_FALSE(timing, ESP_ERR_INVALID_ARG, err, TAG, "invalid led model");
+    ESP_GOTO_ON_FALSE(config->color_order < LED_COLOR_ORDER_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid color order");
+    ESP_GOTO_ON_FALSE(config->bytes_per_pixel == 3 || config->bytes_per_pixel == 4, ESP_ERR_INVALID_ARG, err, TAG, "invalid bytes per pixel");
+    led_encoder = calloc(1, sizeof(rmt_led_strip_encoder_t));
+    ESP_GOTO_ON_FALSE(led_encoder, ESP_ERR_NO_MEM, err, TAG, "no mem for led strip encoder");
+    led_encoder->bytes_per_pixel = config->bytes_per_pixel;
+    led_strip_transform_init(&led_encoder->transform, config->color_order);
+    led_encoder->staged = led_encoder->transform;
+    led_encoder->lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    led_encoder->blank_from = UINT32_MAX;
+    led_encoder->base.encode = rmt_encode_led_strip;
+    led_encoder->base.del = rmt_del_led_strip_encoder;
+    led_encoder->base.reset = rmt_led_strip_encoder_reset;
+    // the capture backend works out the same symbols
+    uint32_t bit0 = 0;
+    uint32_t bit1 = 0;
+    led_strip_get_bit_symbols(timing, config->resolution, &bit0, &bit1);
+    rmt_bytes_encoder_config_t bytes_encoder_config = {
+        .bit0.val = bit0,
+        .bit1.val = bit1,
+        .flags.msb_first = 1 // transfer bit order: G7...G0R7...R0B7...B0(W7...W0)
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_bytes_encoder(&bytes_encoder_config, &led_encoder->bytes_encoder), err, TAG, "create bytes encoder failed");
+    rmt_copy_encoder_config_t copy_encoder_config = {};
+    ESP_GOTO_ON_ERROR(rmt_new_copy_encoder(&copy_encoder_config, &led_encoder->copy_encoder), err, TAG, "create copy encoder failed");
+
+    uint32_t reset_us = config->reset_us ? config->reset_us : timing->reset_us;
+    ESP_GOTO_ON_ERROR(led_strip_get_reset_symbol(reset_us, config->resolution, &led_encoder->reset_code.val), err, TAG, "invalid reset time");
+    *ret_encoder = &led_encoder->base;
+    return ESP_OK;
+err:
+    if (led_encoder) {
+        if (led_encoder->bytes_encoder) {
+            rmt_del_encoder(led_encoder->bytes_encoder);
+        }
+        if (led_encoder->copy_encoder) {
+            rmt_del_encoder(led_encoder->copy_encoder);
+        }
+        free(led_encoder);
+    }
+    return ret;
+}
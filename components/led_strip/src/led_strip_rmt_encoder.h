@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "driver/rmt_encoder.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Type of led strip encoder configuration
+ */
+typedef struct {
+    uint32_t resolution;   /*!< Encoder resolution, in Hz */
+    led_model_t led_model; /*!< LED model */
+    uint32_t reset_us;     /*!< Duration of the reset code, in us. 0 to use the default of the LED model */
+    uint8_t bytes_per_pixel;       /*!< Bytes per pixel of the data to encode, needed by the transform stage */
+    led_color_order_t color_order; /*!< Order in which the color components are sent out */
+} led_strip_encoder_config_t;
+
+/**
+ * @brief Create RMT encoder for encoding LED strip pixels into RMT symbols
+ *
+ * @param[in] config Encoder configuration
+ * @param[out] ret_encoder Returned encoder handle
+ * @return
+ *      - ESP_ERR_INVALID_ARG for any invalid arguments
+ *      - ESP_ERR_NO_MEM out of memory when creating led strip encoder
+ *      - ESP_OK if creating encoder successfully
+ */
+esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder);
+
+/**
+ * @brief Set the brightness that the led strip encoder applies to every color component
+ *
+ * @note The brightness takes effect from the next frame on, a frame being sent out keeps the brightness it started with
+ *
+ * @param[in] encoder Encoder handle, created by `rmt_new_led_strip_encoder`
+ * @param[in] brightness Brightness scale, 255 means no scaling
+ * @return
+ *      - ESP_ERR_INVALID_ARG for any invalid arguments
+ *      - ESP_OK if setting the brightness successfully
+ */
+esp_err_t rmt_led_strip_encoder_set_brightness(rmt_encoder_handle_t encoder, uint8_t brightness);
+
+/**
+ * @brief Set the gamma table that the led strip encoder applies to every color component
+ *
+ * @note The gamma table takes effect from the next frame on, a frame being sent out keeps the table it started with
+ *
+ * @param[in] encoder Encoder handle, created by `rmt_new_led_strip_encoder`
+ * @param[in] gamma_table Table of 256 output values, which is copied into the encoder. NULL to disable the gamma correction
+ * @return
+ *      - ESP_ERR_INVALID_ARG for any invalid arguments
+ *      - ESP_OK if setting the gamma table successfully
+ */
+esp_err_t rmt_led_strip_encoder_set_gamma_table(rmt_encoder_handle_t encoder, const uint8_t *gamma_table);
+
+/**
+ * @brief Set the first pixel that the led strip encoder sends out as zeros instead of the source data
+ *
+ * @note Used to switch off the pixels beyond the active length without writing into the pixel buffer.
+ *       Takes effect from the next transaction, don't call it while one is being encoded.
+ *
+ * @param[in] encoder Encoder handle, created by `rmt_new_led_strip_encoder`
+ * @param[in] first_pixel Index of the first blanked pixel, UINT32_MAX to send every pixel as it is
+ * @return
+ *      - ESP_ERR_INVALID_ARG for any invalid arguments
+ *      - ESP_OK if setting the blanked pixels successfully
+ */
+esp_err_t rmt_led_strip_encoder_set_blank_from(rmt_encoder_handle_t encoder, uint32_t first_pixel);
+
+/**
+ * @brief Get how many times the led strip encoder has been called since the current transaction started
+ *
+ * @note The first call fills the RMT memory when the transaction starts, every further call is a refill from the RMT interrupt.
+ *       Safe to call from the transaction done callback, it is placed in IRAM.
+ *
+ * @param[in] encoder Encoder handle, created by `rmt_new_led_strip_encoder`
+ * @return Number of encode calls
+ */
+uint32_t rmt_led_strip_encoder_get_encode_calls(rmt_encoder_handle_t encoder);
+
+#ifdef __cplusplus
+}
+#endif
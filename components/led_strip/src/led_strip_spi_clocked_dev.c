@@ -0,0 +1,404 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_attr.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_mem.h"
+
+#define LED_STRIP_SPI_CLOCKED_DEFAULT_SPEED_HZ (10 * 1000 * 1000) // 10MHz
+#define LED_STRIP_SPI_CLOCKED_MAX_SPEED_HZ     (20 * 1000 * 1000) // 20MHz
+// size of the internal DMA chunks that a frame in PSRAM is copied through, a multiple of the pixel frame size
+#define LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNK_SIZE 512
+#define LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS     2
+#define LED_STRIP_SPI_CLOCKED_TRANS_QUEUE_SIZE  (LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS + 1) // the pixels (or the bounce chunks) and the end frame
+#define LED_STRIP_SPI_CLOCKED_MAX_BRIGHTNESS   31
+
+// every pixel takes a 32-bit frame: 0b111 + 5-bit global brightness, blue, green, red
+#define LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL 4
+#define LED_STRIP_SPI_CLOCKED_PIXEL_HEADER    0xE0
+// the frame is led by 32 zero bits
+#define LED_STRIP_SPI_CLOCKED_START_FRAME_SIZE 4
+
+static const char *TAG = "led_strip_spi_clocked";
+
+typedef struct {
+    led_strip_t base;
+    spi_host_device_t spi_host;
+    spi_device_handle_t spi_device;
+    uint32_t strip_len;
+    uint32_t active_len;  // number of leading pixels sent by a refresh
+    uint32_t sent_len;    // number of pixels sent by the last frame, the ones beyond the active length need to be blanked once
+    uint8_t header;       // first byte of every pixel frame, carrying the global brightness
+    led_strip_refresh_done_cb_t on_refresh_done;
+    void *user_ctx;
+    uint8_t *end_frame;   // zero bits that clock the data through the whole strip and latch it (SK9822)
+    uint8_t *frame;       // start frame followed by the pixel frames
+    size_t frame_size;    // size of the frame, in bytes
+    bool frame_in_psram;  // the frame is allocated in external RAM and sent through the bounce chunks
+    uint8_t *bounce_chunks[LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS]; // ping-pong DMA chunks, only used when the frame is in PSRAM
+    spi_transaction_t trans[LED_STRIP_SPI_CLOCKED_TRANS_QUEUE_SIZE];
+    uint8_t buffers[];    // frame in internal RAM
+} led_strip_spi_clocked_obj;
+
+// the data is delayed by half a clock cycle per LED, so besides the 32 zero bits that latch a SK9822,
+// the end frame needs at least one more clock edge per two LEDs
+static inline size_t led_strip_spi_clocked_end_frame_size(uint32_t leds)
+{
+    return 4 + (leds + 15) / 16;
+}
+
+static inline uint8_t *led_strip_spi_clocked_pixel(led_strip_spi_clocked_obj *clocked_strip, uint32_t index)
+{
+    return clocked_strip->frame + LED_STRIP_SPI_CLOCKED_START_FRAME_SIZE + index * LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL;
+}
+
+static esp_err_t led_strip_spi_clocked_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    ESP_RETURN_ON_FALSE(index < clocked_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    uint8_t *pixel = led_strip_spi_clocked_pixel(clocked_strip, index);
+    // APA102 component order is BGR
+    pixel[0] = clocked_strip->header;
+    pixel[1] = blue & 0xFF;
+    pixel[2] = green & 0xFF;
+    pixel[3] = red & 0xFF;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    ESP_LOGE(TAG, "wrong LED pixel format, clocked LEDs don't have the white component");
+    return ESP_ERR_INVALID_ARG;
+}
+
+static esp_err_t led_strip_spi_clocked_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    ESP_RETURN_ON_FALSE(start <= clocked_strip->strip_len && count <= clocked_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint8_t *pixel = led_strip_spi_clocked_pixel(clocked_strip, start);
+    for (uint32_t i = 0; i < count; i++) {
+        pixel[0] = clocked_strip->header;
+        pixel[1] = rgb[2];
+        pixel[2] = rgb[1];
+        pixel[3] = rgb[0];
+        pixel += LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL;
+        rgb += 3;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_fill(led_strip_t *strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    ESP_RETURN_ON_FALSE(start <= clocked_strip->strip_len && count <= clocked_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    const uint8_t frame[LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL] = {clocked_strip->header, blue & 0xFF, green & 0xFF, red & 0xFF};
+    uint8_t *pixel = led_strip_spi_clocked_pixel(clocked_strip, start);
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(pixel, frame, LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL);
+        pixel += LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_write_frame(led_strip_t *strip, const uint8_t *frame, size_t size)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    ESP_RETURN_ON_FALSE(size % 3 == 0 && size <= clocked_strip->strip_len * 3, ESP_ERR_INVALID_ARG, TAG, "frame size doesn't fit the LED strip");
+    uint8_t *pixel = led_strip_spi_clocked_pixel(clocked_strip, 0);
+    // the frame is in the GRB pixel format
+    for (size_t i = 0; i < size; i += 3) {
+        pixel[0] = clocked_strip->header;
+        pixel[1] = frame[i + 2];
+        pixel[2] = frame[i + 0];
+        pixel[3] = frame[i + 1];
+        pixel += LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_set_active_length(led_strip_t *strip, uint32_t length)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    ESP_RETURN_ON_FALSE(length && length <= clocked_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "active length out of maximum number of LEDs");
+    clocked_strip->active_len = length;
+    return ESP_OK;
+}
+
+// runs in the SPI interrupt, which is serviced with the flash cache disabled when SPI_MASTER_ISR_IN_IRAM is set (the default)
+static void IRAM_ATTR led_strip_spi_clocked_post_trans_cb(spi_transaction_t *trans)
+{
+    led_strip_spi_clocked_obj *clocked_strip = (led_strip_spi_clocked_obj *)trans->user;
+    // only the end frame carries the strip object
+    if (!clocked_strip) {
+        return;
+    }
+    led_strip_refresh_done_cb_t cb = clocked_strip->on_refresh_done;
+    if (cb && cb(&clocked_strip->base, clocked_strip->user_ctx)) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// send the start frame and the first `len` pixel frames, followed by the end frame
+static esp_err_t led_strip_spi_clocked_send(led_strip_spi_clocked_obj *clocked_strip, uint32_t len)
+{
+    // the LEDs are driven by the clock, so the gaps between the transactions don't matter
+    size_t size = LED_STRIP_SPI_CLOCKED_START_FRAME_SIZE + len * LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL;
+    spi_transaction_t *done_trans = NULL;
+    int trans_in_flight = 0;
+    if (!clocked_strip->frame_in_psram) {
+        spi_transaction_t *pixels_trans = &clocked_strip->trans[0];
+        memset(pixels_trans, 0, sizeof(spi_transaction_t));
+        pixels_trans->length = size * 8;
+        pixels_trans->tx_buffer = clocked_strip->frame;
+        ESP_RETURN_ON_ERROR(spi_device_queue_trans(clocked_strip->spi_device, pixels_trans, portMAX_DELAY), TAG, "queue SPI transaction failed");
+        trans_in_flight++;
+    } else {
+        // copy the frame chunk by chunk into the internal DMA memory: while one chunk is sent out, the other one is refilled
+        size_t offset = 0;
+        int chunk_index = 0;
+        while (offset < size) {
+            if (trans_in_flight == LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS) {
+                ESP_RETURN_ON_ERROR(spi_device_get_trans_result(clocked_strip->spi_device, &done_trans, portMAX_DELAY), TAG, "wait SPI transaction failed");
+                trans_in_flight--;
+            }
+            size_t chunk_size = size - offset;
+            if (chunk_size > LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNK_SIZE) {
+                chunk_size = LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNK_SIZE;
+            }
+            memcpy(clocked_strip->bounce_chunks[chunk_index], clocked_strip->frame + offset, chunk_size);
+            spi_transaction_t *chunk_trans = &clocked_strip->trans[chunk_index];
+            memset(chunk_trans, 0, sizeof(spi_transaction_t));
+            chunk_trans->length = chunk_size * 8;
+            chunk_trans->tx_buffer = clocked_strip->bounce_chunks[chunk_index];
+            ESP_RETURN_ON_ERROR(spi_device_queue_trans(clocked_strip->spi_device, chunk_trans, portMAX_DELAY), TAG, "queue SPI transaction failed");
+            trans_in_flight++;
+            offset += chunk_size;
+            chunk_index = (chunk_index + 1) % LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS;
+        }
+    }
+
+    spi_transaction_t *end_trans = &clocked_strip->trans[LED_STRIP_SPI_CLOCKED_TRANS_QUEUE_SIZE - 1];
+    memset(end_trans, 0, sizeof(spi_transaction_t));
+    end_trans->length = led_strip_spi_clocked_end_frame_size(len) * 8;
+    end_trans->tx_buffer = clocked_strip->end_frame;
+    end_trans->user = clocked_strip;
+    ESP_RETURN_ON_ERROR(spi_device_queue_trans(clocked_strip->spi_device, end_trans, portMAX_DELAY), TAG, "queue SPI transaction failed");
+    trans_in_flight++;
+    while (trans_in_flight) {
+        ESP_RETURN_ON_ERROR(spi_device_get_trans_result(clocked_strip->spi_device, &done_trans, portMAX_DELAY), TAG, "wait SPI transaction failed");
+        trans_in_flight--;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_refresh(led_strip_t *strip)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    uint32_t len = clocked_strip->sent_len > clocked_strip->active_len ? clocked_strip->sent_len : clocked_strip->active_len;
+    // the pixels that the last frame lit beyond the active length go out once with a zero global brightness,
+    // only their header is changed for this frame, so they keep their colors
+    for (uint32_t i = clocked_strip->active_len; i < len; i++) {
+        *led_strip_spi_clocked_pixel(clocked_strip, i) = LED_STRIP_SPI_CLOCKED_PIXEL_HEADER;
+    }
+    esp_err_t ret = led_strip_spi_clocked_send(clocked_strip, len);
+    for (uint32_t i = clocked_strip->active_len; i < len; i++) {
+        *led_strip_spi_clocked_pixel(clocked_strip, i) = clocked_strip->header;
+    }
+    if (ret == ESP_OK) {
+        clocked_strip->sent_len = clocked_strip->active_len;
+    }
+    return ret;
+}
+
+static esp_err_t led_strip_spi_clocked_register_event_callbacks(led_strip_t *strip, const led_strip_event_callbacks_t *cbs, void *user_ctx)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    clocked_strip->user_ctx = user_ctx;
+    clocked_strip->on_refresh_done = cbs->on_refresh_done;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_get_event_callbacks(led_strip_t *strip, led_strip_event_callbacks_t *ret_cbs, void **ret_user_ctx)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    ret_cbs->on_refresh_done = clocked_strip->on_refresh_done;
+    *ret_user_ctx = clocked_strip->user_ctx;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_clear(led_strip_t *strip)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    // Write zero to turn off all leds
+    ESP_RETURN_ON_ERROR(led_strip_spi_clocked_fill(strip, 0, clocked_strip->strip_len, 0, 0, 0), TAG, "clear pixels failed");
+    return led_strip_spi_clocked_refresh(strip);
+}
+
+static esp_err_t led_strip_spi_clocked_set_brightness(led_strip_t *strip, uint8_t brightness)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    // scale the brightness down to the 5-bit global brightness of the LEDs
+    clocked_strip->header = LED_STRIP_SPI_CLOCKED_PIXEL_HEADER | ((brightness * LED_STRIP_SPI_CLOCKED_MAX_BRIGHTNESS + 127) / 255);
+    for (uint32_t i = 0; i < clocked_strip->strip_len; i++) {
+        *led_strip_spi_clocked_pixel(clocked_strip, i) = clocked_strip->header;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_get_mem_report(led_strip_t *strip, led_strip_mem_report_t *report)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    if (clocked_strip->frame_in_psram) {
+        led_strip_mem_report_add(report, clocked_strip, sizeof(led_strip_spi_clocked_obj));
+        led_strip_mem_report_add(report, clocked_strip->frame, clocked_strip->frame_size);
+    } else {
+        led_strip_mem_report_add(report, clocked_strip, sizeof(led_strip_spi_clocked_obj) + clocked_strip->frame_size);
+    }
+    led_strip_mem_report_add(report, clocked_strip->end_frame, led_strip_spi_clocked_end_frame_size(clocked_strip->strip_len));
+    for (int i = 0; i < LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS; i++) {
+        led_strip_mem_report_add(report, clocked_strip->bounce_chunks[i], LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNK_SIZE);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clocked_del(led_strip_t *strip)
+{
+    led_strip_spi_clocked_obj *clocked_strip = __containerof(strip, led_strip_spi_clocked_obj, base);
+    ESP_RETURN_ON_ERROR(spi_bus_remove_device(clocked_strip->spi_device), TAG, "delete spi device failed");
+    ESP_RETURN_ON_ERROR(spi_bus_free(clocked_strip->spi_host), TAG, "free spi bus failed");
+    for (int i = 0; i < LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS; i++) {
+        free(clocked_strip->bounce_chunks[i]);
+    }
+    if (clocked_strip->frame_in_psram) {
+        free(clocked_strip->frame);
+    }
+    free(clocked_strip->end_frame);
+    free(clocked_strip);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_spi_clocked_device(const led_strip_config_t *led_config, const led_strip_spi_clocked_config_t *clocked_config, led_strip_handle_t *ret_strip)
+{
+    led_strip_spi_clocked_obj *clocked_strip = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config && clocked_config && ret_strip, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(led_config->led_model == LED_MODEL_APA102 || led_config->led_model == LED_MODEL_SK9822, ESP_ERR_INVALID_ARG, err, TAG,
+                      "invalid led_model, only clocked LEDs are supported");
+    ESP_GOTO_ON_FALSE(led_config->led_pixel_format == LED_PIXEL_FORMAT_GRB, ESP_ERR_INVALID_ARG, err, TAG, "invalid led_pixel_format");
+    ESP_GOTO_ON_FALSE(!led_config->pixel_buf, ESP_ERR_NOT_SUPPORTED, err, TAG, "caller-owned pixel buffer is not supported");
+    ESP_GOTO_ON_FALSE(!led_config->flags.invert_out, ESP_ERR_NOT_SUPPORTED, err, TAG, "inverted output is not supported");
+    ESP_GOTO_ON_FALSE(clocked_config->clock_speed_hz <= LED_STRIP_SPI_CLOCKED_MAX_SPEED_HZ, ESP_ERR_INVALID_ARG, err, TAG, "clock speed too high");
+    ESP_GOTO_ON_FALSE(clocked_config->global_brightness <= LED_STRIP_SPI_CLOCKED_MAX_BRIGHTNESS, ESP_ERR_INVALID_ARG, err, TAG, "invalid global brightness");
+    bool in_psram = led_config->flags.pixel_buf_in_psram;
+    ESP_GOTO_ON_FALSE(!in_psram || clocked_config->flags.with_dma, ESP_ERR_NOT_SUPPORTED, err, TAG, "PSRAM pixel buffer requires DMA");
+
+    size_t frame_size = LED_STRIP_SPI_CLOCKED_START_FRAME_SIZE + led_config->max_leds * LED_STRIP_SPI_CLOCKED_BYTES_PER_PIXEL;
+    size_t end_frame_size = led_strip_spi_clocked_end_frame_size(led_config->max_leds);
+    uint32_t mem_caps = MALLOC_CAP_DEFAULT;
+    if (clocked_config->flags.with_dma) {
+        // DMA buffer must be placed in internal SRAM
+        mem_caps |= MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+    }
+    // the start frame and the end frame are all zero bits
+    clocked_strip = heap_caps_calloc(1, sizeof(led_strip_spi_clocked_obj) + (in_psram ? 0 : frame_size), mem_caps);
+    ESP_GOTO_ON_FALSE(clocked_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for spi clocked strip");
+    clocked_strip->frame = clocked_strip->buffers;
+    clocked_strip->frame_size = frame_size;
+    size_t max_transfer_size = frame_size;
+    if (in_psram) {
+        // the DMA can't read the external RAM, the frame is copied through the internal bounce chunks on refresh
+        clocked_strip->frame_in_psram = true;
+        clocked_strip->frame = heap_caps_calloc(1, frame_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        ESP_GOTO_ON_FALSE(clocked_strip->frame, ESP_ERR_NO_MEM, err, TAG, "no mem for frame in PSRAM");
+        for (int i = 0; i < LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS; i++) {
+            clocked_strip->bounce_chunks[i] = heap_caps_calloc(1, LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNK_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+            ESP_GOTO_ON_FALSE(clocked_strip->bounce_chunks[i], ESP_ERR_NO_MEM, err, TAG, "no mem for bounce chunk");
+        }
+        max_transfer_size = LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNK_SIZE;
+    }
+    clocked_strip->end_frame = heap_caps_calloc(1, end_frame_size, mem_caps);
+    ESP_GOTO_ON_FALSE(clocked_strip->end_frame, ESP_ERR_NO_MEM, err, TAG, "no mem for end frame");
+
+    clocked_strip->spi_host = clocked_config->spi_bus;
+    // for backward compatibility, if the user does not set the clk_src, use the default value
+    spi_clock_source_t clk_src = SPI_CLK_SRC_DEFAULT;
+    if (clocked_config->clk_src) {
+        clk_src = clocked_config->clk_src;
+    }
+
+    spi_bus_config_t spi_bus_cfg = {
+        .mosi_io_num = led_config->strip_gpio_num,
+        .sclk_io_num = clocked_config->clk_gpio_num,
+        //Only use MOSI and SCLK, set -1 when other pins are not used.
+        .miso_io_num = -1,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = max_transfer_size,
+    };
+    ESP_GOTO_ON_ERROR(spi_bus_initialize(clocked_strip->spi_host, &spi_bus_cfg, clocked_config->flags.with_dma ? SPI_DMA_CH_AUTO : SPI_DMA_DISABLED), err, TAG, "create SPI bus failed");
+
+    spi_device_interface_config_t spi_dev_cfg = {
+        .clock_source = clk_src,
+        .command_bits = 0,
+        .address_bits = 0,
+        .dummy_bits = 0,
+        .clock_speed_hz = clocked_config->clock_speed_hz ? clocked_config->clock_speed_hz : LED_STRIP_SPI_CLOCKED_DEFAULT_SPEED_HZ,
+        .mode = 0, // data is latched on the rising edge of the clock
+        //set -1 when CS is not used
+        .spics_io_num = -1,
+        .queue_size = LED_STRIP_SPI_CLOCKED_TRANS_QUEUE_SIZE,
+        .post_cb = led_strip_spi_clocked_post_trans_cb,
+    };
+    ESP_GOTO_ON_ERROR(spi_bus_add_device(clocked_strip->spi_host, &spi_dev_cfg, &clocked_strip->spi_device), err, TAG, "Failed to add spi device");
+
+    clocked_strip->strip_len = led_config->max_leds;
+    clocked_strip->active_len = led_config->max_leds;
+    clocked_strip->sent_len = led_config->max_leds;
+    uint8_t global_brightness = clocked_config->global_brightness ? clocked_config->global_brightness : LED_STRIP_SPI_CLOCKED_MAX_BRIGHTNESS;
+    clocked_strip->header = LED_STRIP_SPI_CLOCKED_PIXEL_HEADER | global_brightness;
+    // all the pixels start off
+    led_strip_spi_clocked_fill(&clocked_strip->base, 0, led_config->max_leds, 0, 0, 0);
+
+    clocked_strip->base.set_pixel = led_strip_spi_clocked_set_pixel;
+    clocked_strip->base.set_pixel_rgbw = led_strip_spi_clocked_set_pixel_rgbw;
+    clocked_strip->base.set_pixels = led_strip_spi_clocked_set_pixels;
+    clocked_strip->base.fill = led_strip_spi_clocked_fill;
+    clocked_strip->base.write_frame = led_strip_spi_clocked_write_frame;
+    clocked_strip->base.set_active_length = led_strip_spi_clocked_set_active_length;
+    clocked_strip->base.refresh = led_strip_spi_clocked_refresh;
+    clocked_strip->base.register_event_callbacks = led_strip_spi_clocked_register_event_callbacks;
+    clocked_strip->base.get_event_callbacks = led_strip_spi_clocked_get_event_callbacks;
+    clocked_strip->base.clear = led_strip_spi_clocked_clear;
+    clocked_strip->base.set_brightness = led_strip_spi_clocked_set_brightness;
+    clocked_strip->base.get_mem_report = led_strip_spi_clocked_get_mem_report;
+    clocked_strip->base.del = led_strip_spi_clocked_del;
+
+    *ret_strip = &clocked_strip->base;
+    return ESP_OK;
+err:
+    if (clocked_strip) {
+        if (clocked_strip->spi_device) {
+            spi_bus_remove_device(clocked_strip->spi_device);
+        }
+        if (clocked_strip->spi_host) {
+            spi_bus_free(clocked_strip->spi_host);
+        }
+        for (int i = 0; i < LED_STRIP_SPI_CLOCKED_BOUNCE_CHUNKS; i++) {
+            free(clocked_strip->bounce_chunks[i]);
+        }
+        if (clocked_strip->frame_in_psram) {
+            free(clocked_strip->frame);
+        }
+        free(clocked_strip->end_frame);
+        free(clocked_strip);
+    }
+    return ret;
+}
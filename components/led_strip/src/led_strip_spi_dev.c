@@ -0,0 +1,608 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_attr.h"
+#include "esp_rom_gpio.h"
+#include "soc/spi_periph.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_spi_encoder.h"
+#include "led_strip_timing.h"
+#include "led_strip_mem.h"
+#include "hal/spi_hal.h"
+
+#define LED_STRIP_SPI_DEFAULT_RESOLUTION (2.5 * 1000 * 1000) // 2.5MHz resolution
+#define LED_STRIP_SPI_DEFAULT_TRANS_QUEUE_SIZE 4
+#define LED_STRIP_SPI_MAX_FRAME_BUFFERS 4
+// default number of color bytes encoded into one DMA chunk in streaming mode, a multiple of both 3 and 4 bytes per pixel
+#define LED_STRIP_SPI_DEFAULT_STREAM_CHUNK_SIZE 96
+#define LED_STRIP_SPI_DEFAULT_STREAM_CHUNKS 2
+// every chunk is queued as one transaction, the transaction descriptors are shared with the frame buffers
+#define LED_STRIP_SPI_MAX_STREAM_CHUNKS LED_STRIP_SPI_MAX_FRAME_BUFFERS
+
+#define SPI_BITS_PER_COLOR_BYTE (SPI_BYTES_PER_COLOR_BYTE * 8)
+
+static const char *TAG = "led_strip_spi";
+
+typedef struct {
+    led_strip_t base;
+    spi_host_device_t spi_host;
+    spi_device_handle_t spi_device;
+    uint32_t strip_len;
+    uint32_t active_len;       // number of leading pixels sent by a refresh
+    uint32_t sent_len;         // number of pixels sent by the last frame, the ones beyond the active length need to be blanked once
+    uint8_t bytes_per_pixel;
+    uint8_t *pixel_buf;        // encoded frame that the pixels are drawn into
+    uint8_t num_frame_buffers; // number of encoded frames in the pipeline
+    uint8_t draw_index;        // index of the frame buffer that pixel_buf points to
+    uint8_t trans_in_flight;   // number of queued transactions whose result hasn't been collected
+    led_strip_refresh_done_cb_t on_refresh_done;
+    void *user_ctx;
+    uint8_t *frame_bufs[LED_STRIP_SPI_MAX_FRAME_BUFFERS];
+    uint8_t *stream_chunks[LED_STRIP_SPI_MAX_STREAM_CHUNKS]; // DMA chunks refilled in turn, only used in streaming mode
+    uint8_t num_stream_chunks; // number of DMA chunks, 0 if not in streaming mode
+    size_t stream_chunk_size;  // color bytes encoded into one DMA chunk
+    spi_transaction_t trans[LED_STRIP_SPI_MAX_FRAME_BUFFERS];
+    size_t buffers_size;       // size of the frame buffers allocated by the driver
+    uint8_t *ext_buffers;      // pixel buffer in external RAM, NULL if the frame buffers follow the object
+    uint8_t buffers[];
+} led_strip_spi_obj;
+
+// fill `size` bytes of buf by repeating the `pattern`, doubling the copied span each round
+static void led_strip_spi_fill_pattern(uint8_t *buf, const uint8_t *pattern, size_t pattern_size, size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    size_t copied = pattern_size < size ? pattern_size : size;
+    if (buf != pattern) {
+        memcpy(buf, pattern, copied);
+    }
+    while (copied < size) {
+        size_t chunk = copied < size - copied ? copied : size - copied;
+        memcpy(buf + copied, buf, chunk);
+        copied += chunk;
+    }
+}
+
+static esp_err_t led_strip_spi_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(index < spi_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    // LED_PIXEL_FORMAT_GRB takes 72bits(9bytes)
+    uint32_t start = index * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    led_strip_spi_encode_byte(green & 0xFF, &spi_strip->pixel_buf[start]);
+    led_strip_spi_encode_byte(red & 0xFF, &spi_strip->pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE]);
+    led_strip_spi_encode_byte(blue & 0xFF, &spi_strip->pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * 2]);
+    if (spi_strip->bytes_per_pixel > 3) {
+        led_strip_spi_encode_byte(0, &spi_strip->pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * 3]);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(index < spi_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(spi_strip->bytes_per_pixel == 4, ESP_ERR_INVALID_ARG, TAG, "wrong LED pixel format, expected 4 bytes per pixel");
+    // LED_PIXEL_FORMAT_GRBW takes 96bits(12bytes)
+    uint32_t start = index * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    // SK6812 component order is GRBW
+    led_strip_spi_encode_byte(green & 0xFF, &spi_strip->pixel_buf[start]);
+    led_strip_spi_encode_byte(red & 0xFF, &spi_strip->pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE]);
+    led_strip_spi_encode_byte(blue & 0xFF, &spi_strip->pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * 2]);
+    led_strip_spi_encode_byte(white & 0xFF, &spi_strip->pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * 3]);
+
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(start <= spi_strip->strip_len && count <= spi_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint32_t pixel_size = spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    uint8_t *buf = spi_strip->pixel_buf + start * pixel_size;
+    for (uint32_t i = 0; i < count; i++) {
+        // In the order of GRB
+        led_strip_spi_encode_byte(rgb[1], buf);
+        led_strip_spi_encode_byte(rgb[0], buf + SPI_BYTES_PER_COLOR_BYTE);
+        led_strip_spi_encode_byte(rgb[2], buf + SPI_BYTES_PER_COLOR_BYTE * 2);
+        if (spi_strip->bytes_per_pixel > 3) {
+            led_strip_spi_encode_byte(0, buf + SPI_BYTES_PER_COLOR_BYTE * 3);
+        }
+        buf += pixel_size;
+        rgb += 3;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_fill(led_strip_t *strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(start <= spi_strip->strip_len && count <= spi_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    if (count == 0) {
+        return ESP_OK;
+    }
+    uint32_t pixel_size = spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    uint8_t *first = spi_strip->pixel_buf + start * pixel_size;
+    // encode the color once, then replicate the encoded pixel over the range
+    led_strip_spi_set_pixel(strip, start, red, green, blue);
+    led_strip_spi_fill_pattern(first, first, pixel_size, count * pixel_size);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_write_frame(led_strip_t *strip, const uint8_t *frame, size_t size)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(size % spi_strip->bytes_per_pixel == 0 && size <= spi_strip->strip_len * spi_strip->bytes_per_pixel, ESP_ERR_INVALID_ARG, TAG,
+                        "frame size doesn't fit the LED strip");
+    led_strip_spi_encode(frame, size, spi_strip->pixel_buf);
+    return ESP_OK;
+}
+
+// runs in the SPI interrupt, which is serviced with the flash cache disabled when SPI_MASTER_ISR_IN_IRAM is set (the default)
+static void IRAM_ATTR led_strip_spi_post_trans_cb(spi_transaction_t *trans)
+{
+    led_strip_spi_obj *spi_strip = (led_strip_spi_obj *)trans->user;
+    // in streaming mode, only the last chunk of a frame carries the strip object
+    if (!spi_strip) {
+        return;
+    }
+    led_strip_refresh_done_cb_t cb = spi_strip->on_refresh_done;
+    if (cb && cb(&spi_strip->base, spi_strip->user_ctx)) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// collect the results of the queued transactions, oldest first
+static esp_err_t led_strip_spi_collect_trans(led_strip_spi_obj *spi_strip, uint8_t remain, TickType_t ticks_to_wait)
+{
+    spi_transaction_t *done_trans = NULL;
+    while (spi_strip->trans_in_flight > remain) {
+        esp_err_t ret = spi_device_get_trans_result(spi_strip->spi_device, &done_trans, ticks_to_wait);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        spi_strip->trans_in_flight--;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_active_length(led_strip_t *strip, uint32_t length)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(length && length <= spi_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "active length out of maximum number of LEDs");
+    spi_strip->active_len = length;
+    return ESP_OK;
+}
+
+// number of pixels a refresh sends, covering the ones that the last frame lit beyond the active length
+static inline uint32_t led_strip_spi_frame_len(led_strip_spi_obj *spi_strip)
+{
+    return spi_strip->sent_len > spi_strip->active_len ? spi_strip->sent_len : spi_strip->active_len;
+}
+
+// returns the number of color bytes in the drawn frame to send, the encoded pixels beyond the active length are blanked in the frame
+static size_t led_strip_spi_prepare_frame(led_strip_spi_obj *spi_strip)
+{
+    uint32_t len = led_strip_spi_frame_len(spi_strip);
+    if (len > spi_strip->active_len) {
+        // unlike a raw pixel buffer, the encoded frame isn't handed out, so the blanked pixels are simply written over
+        size_t offset = spi_strip->active_len * spi_strip->bytes_per_pixel;
+        size_t size = (len - spi_strip->active_len) * spi_strip->bytes_per_pixel;
+        led_strip_spi_fill_pattern(spi_strip->pixel_buf + offset * SPI_BYTES_PER_COLOR_BYTE, led_strip_spi_lut[0], SPI_BYTES_PER_COLOR_BYTE,
+                                   size * SPI_BYTES_PER_COLOR_BYTE);
+    }
+    return len * spi_strip->bytes_per_pixel;
+}
+
+static esp_err_t led_strip_spi_refresh(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    // a polling transmit can't be mixed with pending queued transactions
+    ESP_RETURN_ON_ERROR(led_strip_spi_collect_trans(spi_strip, 0, portMAX_DELAY), TAG, "wait pending transactions failed");
+    spi_transaction_t *tx_conf = &spi_strip->trans[spi_strip->draw_index];
+    memset(tx_conf, 0, sizeof(spi_transaction_t));
+
+    tx_conf->length = led_strip_spi_prepare_frame(spi_strip) * SPI_BITS_PER_COLOR_BYTE;
+    tx_conf->tx_buffer = spi_strip->pixel_buf;
+    tx_conf->rx_buffer = NULL;
+    tx_conf->user = spi_strip;
+    ESP_RETURN_ON_ERROR(spi_device_transmit(spi_strip->spi_device, tx_conf), TAG, "transmit pixels by SPI failed");
+    spi_strip->sent_len = spi_strip->active_len;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_refresh_async(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    spi_transaction_t *tx_conf = &spi_strip->trans[spi_strip->draw_index];
+    memset(tx_conf, 0, sizeof(spi_transaction_t));
+
+    tx_conf->length = led_strip_spi_prepare_frame(spi_strip) * SPI_BITS_PER_COLOR_BYTE;
+    tx_conf->tx_buffer = spi_strip->pixel_buf;
+    tx_conf->rx_buffer = NULL;
+    tx_conf->user = spi_strip;
+    ESP_RETURN_ON_ERROR(spi_device_queue_trans(spi_strip->spi_device, tx_conf, portMAX_DELAY), TAG, "queue SPI transaction failed");
+    spi_strip->trans_in_flight++;
+    spi_strip->sent_len = spi_strip->active_len;
+
+    // hand out the next frame buffer for drawing, the frame buffers are queued in order,
+    // so if all of them are in flight, the next one is the oldest and finishes first
+    spi_strip->draw_index = (spi_strip->draw_index + 1) % spi_strip->num_frame_buffers;
+    ESP_RETURN_ON_ERROR(led_strip_spi_collect_trans(spi_strip, spi_strip->num_frame_buffers - 1, portMAX_DELAY), TAG, "wait free frame buffer failed");
+    spi_strip->pixel_buf = spi_strip->frame_bufs[spi_strip->draw_index];
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_wait_refresh_done(led_strip_t *strip, int32_t timeout_ms)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    TickType_t ticks_to_wait = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    // not logging here, as a timeout is an expected result when polling
+    return led_strip_spi_collect_trans(spi_strip, 0, ticks_to_wait);
+}
+
+static esp_err_t led_strip_spi_register_event_callbacks(led_strip_t *strip, const led_strip_event_callbacks_t *cbs, void *user_ctx)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    spi_strip->user_ctx = user_ctx;
+    spi_strip->on_refresh_done = cbs->on_refresh_done;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_get_event_callbacks(led_strip_t *strip, led_strip_event_callbacks_t *ret_cbs, void **ret_user_ctx)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ret_cbs->on_refresh_done = spi_strip->on_refresh_done;
+    *ret_user_ctx = spi_strip->user_ctx;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clear(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    //Write the encoding of zero to turn off all leds
+    led_strip_spi_fill_pattern(spi_strip->pixel_buf, led_strip_spi_lut[0], SPI_BYTES_PER_COLOR_BYTE,
+                               spi_strip->strip_len * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE);
+
+    return led_strip_spi_refresh(strip);
+}
+
+static esp_err_t led_strip_spi_stream_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(index < spi_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    uint8_t *buf = spi_strip->pixel_buf + index * spi_strip->bytes_per_pixel;
+    // In the order of GRB, the encoding into SPI bits happens during the refresh
+    buf[0] = green & 0xFF;
+    buf[1] = red & 0xFF;
+    buf[2] = blue & 0xFF;
+    if (spi_strip->bytes_per_pixel > 3) {
+        buf[3] = 0;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_stream_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(index < spi_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(spi_strip->bytes_per_pixel == 4, ESP_ERR_INVALID_ARG, TAG, "wrong LED pixel format, expected 4 bytes per pixel");
+    uint8_t *buf = spi_strip->pixel_buf + index * 4;
+    // SK6812 component order is GRBW
+    buf[0] = green & 0xFF;
+    buf[1] = red & 0xFF;
+    buf[2] = blue & 0xFF;
+    buf[3] = white & 0xFF;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_stream_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(start <= spi_strip->strip_len && count <= spi_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    uint8_t bytes_per_pixel = spi_strip->bytes_per_pixel;
+    uint8_t *buf = spi_strip->pixel_buf + start * bytes_per_pixel;
+    for (uint32_t i = 0; i < count; i++) {
+        buf[0] = rgb[1];
+        buf[1] = rgb[0];
+        buf[2] = rgb[2];
+        if (bytes_per_pixel > 3) {
+            buf[3] = 0;
+        }
+        buf += bytes_per_pixel;
+        rgb += 3;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_stream_fill(led_strip_t *strip, uint32_t start, uint32_t count, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(start <= spi_strip->strip_len && count <= spi_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixel range out of maximum number of LEDs");
+    const uint8_t pixel[4] = {green & 0xFF, red & 0xFF, blue & 0xFF, 0};
+    led_strip_spi_fill_pattern(spi_strip->pixel_buf + start * spi_strip->bytes_per_pixel, pixel, spi_strip->bytes_per_pixel,
+                               count * spi_strip->bytes_per_pixel);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_stream_write_frame(led_strip_t *strip, const uint8_t *frame, size_t size)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(size % spi_strip->bytes_per_pixel == 0 && size <= spi_strip->strip_len * spi_strip->bytes_per_pixel, ESP_ERR_INVALID_ARG, TAG,
+                        "frame size doesn't fit the LED strip");
+    memcpy(spi_strip->pixel_buf, frame, size);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_stream_get_buffer(led_strip_t *strip, uint8_t **ret_buf, size_t *ret_size)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    *ret_buf = spi_strip->pixel_buf;
+    *ret_size = spi_strip->strip_len * spi_strip->bytes_per_pixel;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_stream_refresh(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    // the raw pixels beyond the active length are left alone, the chunks get the encoding of zero in their place
+    size_t active_size = spi_strip->active_len * spi_strip->bytes_per_pixel;
+    size_t frame_size = led_strip_spi_frame_len(spi_strip) * spi_strip->bytes_per_pixel;
+    size_t offset = 0;
+    int chunk_index = 0;
+    spi_transaction_t *done_trans = NULL;
+
+    // Encode the raw pixels chunk by chunk: while the DMA drains the queued chunks, the one sent out last is refilled.
+    // The refill runs in this task, so the wire only keeps going if the task gets the CPU back before the queued chunks run out,
+    // i.e. within (num_stream_chunks - 1) chunk times plus the reset time of the LED model. A longer delay latches a partial frame.
+    while (offset < frame_size || spi_strip->trans_in_flight) {
+        if (offset < frame_size && spi_strip->trans_in_flight < spi_strip->num_stream_chunks) {
+            size_t chunk_size = frame_size - offset;
+            if (chunk_size > spi_strip->stream_chunk_size) {
+                chunk_size = spi_strip->stream_chunk_size;
+            }
+            uint8_t *chunk = spi_strip->stream_chunks[chunk_index];
+            size_t pixel_size = offset < active_size ? active_size - offset : 0;
+            if (pixel_size > chunk_size) {
+                pixel_size = chunk_size;
+            }
+            led_strip_spi_encode(spi_strip->pixel_buf + offset, pixel_size, chunk);
+            led_strip_spi_fill_pattern(chunk + pixel_size * SPI_BYTES_PER_COLOR_BYTE, led_strip_spi_lut[0], SPI_BYTES_PER_COLOR_BYTE,
+                                       (chunk_size - pixel_size) * SPI_BYTES_PER_COLOR_BYTE);
+            offset += chunk_size;
+
+            spi_transaction_t *tx_conf = &spi_strip->trans[chunk_index];
+            memset(tx_conf, 0, sizeof(spi_transaction_t));
+            tx_conf->length = chunk_size * SPI_BITS_PER_COLOR_BYTE;
+            tx_conf->tx_buffer = chunk;
+            tx_conf->user = offset == frame_size ? spi_strip : NULL;
+            ESP_RETURN_ON_ERROR(spi_device_queue_trans(spi_strip->spi_device, tx_conf, portMAX_DELAY), TAG, "queue SPI transaction failed");
+            spi_strip->trans_in_flight++;
+            chunk_index = (chunk_index + 1) % spi_strip->num_stream_chunks;
+        } else {
+            ESP_RETURN_ON_ERROR(spi_device_get_trans_result(spi_strip->spi_device, &done_trans, portMAX_DELAY), TAG, "wait SPI transaction failed");
+            spi_strip->trans_in_flight--;
+        }
+    }
+    spi_strip->sent_len = spi_strip->active_len;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_stream_clear(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    // Write zero to turn off all leds
+    memset(spi_strip->pixel_buf, 0, spi_strip->strip_len * spi_strip->bytes_per_pixel);
+    return led_strip_spi_stream_refresh(strip);
+}
+
+static esp_err_t led_strip_spi_get_mem_report(led_strip_t *strip, led_strip_mem_report_t *report)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    if (spi_strip->ext_buffers) {
+        led_strip_mem_report_add(report, spi_strip, sizeof(led_strip_spi_obj));
+        led_strip_mem_report_add(report, spi_strip->ext_buffers, spi_strip->buffers_size);
+    } else {
+        led_strip_mem_report_add(report, spi_strip, sizeof(led_strip_spi_obj) + spi_strip->buffers_size);
+    }
+    for (int i = 0; i < spi_strip->num_stream_chunks; i++) {
+        led_strip_mem_report_add(report, spi_strip->stream_chunks[i], spi_strip->stream_chunk_size * SPI_BYTES_PER_COLOR_BYTE);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_del(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+
+    ESP_RETURN_ON_ERROR(led_strip_spi_collect_trans(spi_strip, 0, portMAX_DELAY), TAG, "wait pending transactions failed");
+    ESP_RETURN_ON_ERROR(spi_bus_remove_device(spi_strip->spi_device), TAG, "delete spi device failed");
+    ESP_RETURN_ON_ERROR(spi_bus_free(spi_strip->spi_host), TAG, "free spi bus failed");
+
+    for (int i = 0; i < LED_STRIP_SPI_MAX_STREAM_CHUNKS; i++) {
+        free(spi_strip->stream_chunks[i]);
+    }
+    free(spi_strip->ext_buffers);
+    free(spi_strip);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_spi_device(const led_strip_config_t *led_config, const led_strip_spi_config_t *spi_config, led_strip_handle_t *ret_strip)
+{
+    led_strip_spi_obj *spi_strip = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config && spi_config && ret_strip, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(led_config->led_pixel_format < LED_PIXEL_FORMAT_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led_pixel_format");
+    ESP_GOTO_ON_FALSE(led_strip_get_timing(led_config->led_model), ESP_ERR_INVALID_ARG, err, TAG, "invalid led_model, clocked LEDs need the clocked SPI backend");
+    uint8_t bytes_per_pixel = 3;
+    if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRBW) {
+        bytes_per_pixel = 4;
+    } else if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRB) {
+        bytes_per_pixel = 3;
+    } else {
+        assert(false);
+    }
+    uint8_t num_frame_buffers = spi_config->num_frame_buffers ? spi_config->num_frame_buffers : 1;
+    ESP_GOTO_ON_FALSE(num_frame_buffers <= LED_STRIP_SPI_MAX_FRAME_BUFFERS, ESP_ERR_INVALID_ARG, err, TAG, "too many frame buffers");
+    bool streaming = spi_config->flags.streaming;
+    ESP_GOTO_ON_FALSE(!streaming || spi_config->flags.with_dma, ESP_ERR_NOT_SUPPORTED, err, TAG, "streaming mode requires DMA");
+    ESP_GOTO_ON_FALSE(!streaming || num_frame_buffers == 1, ESP_ERR_INVALID_ARG, err, TAG, "streaming mode can't be used with multiple frame buffers");
+    uint8_t num_stream_chunks = spi_config->stream_chunks ? spi_config->stream_chunks : LED_STRIP_SPI_DEFAULT_STREAM_CHUNKS;
+    ESP_GOTO_ON_FALSE(num_stream_chunks >= 2 && num_stream_chunks <= LED_STRIP_SPI_MAX_STREAM_CHUNKS, ESP_ERR_INVALID_ARG, err, TAG, "invalid number of stream chunks");
+    size_t stream_chunk_size = spi_config->stream_chunk_size ? spi_config->stream_chunk_size : LED_STRIP_SPI_DEFAULT_STREAM_CHUNK_SIZE;
+    // only the streaming mode keeps the pixels in the pixel format, otherwise the buffer holds the SPI waveform
+    ESP_GOTO_ON_FALSE(!led_config->pixel_buf || streaming, ESP_ERR_NOT_SUPPORTED, err, TAG, "caller-owned pixel buffer requires streaming mode");
+    // the DMA can't read the external RAM, so the pixels in PSRAM are encoded into the internal stream chunks, which act as bounce buffers
+    bool in_psram = led_config->flags.pixel_buf_in_psram && !led_config->pixel_buf;
+    ESP_GOTO_ON_FALSE(!in_psram || streaming, ESP_ERR_NOT_SUPPORTED, err, TAG, "PSRAM pixel buffer requires streaming mode");
+    size_t frame_size = led_config->max_leds * bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    size_t max_transfer_size = frame_size;
+    if (streaming) {
+        // only the raw pixels are kept, the encoded waveform lives in the DMA chunks
+        frame_size = led_config->max_leds * bytes_per_pixel;
+        max_transfer_size = stream_chunk_size * SPI_BYTES_PER_COLOR_BYTE;
+    }
+    // keep every frame buffer word aligned for the DMA
+    size_t frame_stride = (frame_size + 3) & ~(size_t)3;
+    uint32_t mem_caps = MALLOC_CAP_DEFAULT;
+    if (spi_config->flags.with_dma && !streaming) {
+        // DMA buffer must be placed in internal SRAM
+        mem_caps |= MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+    }
+    if (led_config->pixel_buf) {
+        frame_stride = 0;
+    }
+    spi_strip = heap_caps_calloc(1, sizeof(led_strip_spi_obj) + (in_psram ? 0 : frame_stride * num_frame_buffers), mem_caps);
+
+    ESP_GOTO_ON_FALSE(spi_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for spi strip");
+    spi_strip->buffers_size = frame_stride * num_frame_buffers;
+    uint8_t *buffers = spi_strip->buffers;
+    if (in_psram) {
+        spi_strip->ext_buffers = heap_caps_calloc(1, spi_strip->buffers_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        ESP_GOTO_ON_FALSE(spi_strip->ext_buffers, ESP_ERR_NO_MEM, err, TAG, "no mem for pixel buffer in PSRAM");
+        buffers = spi_strip->ext_buffers;
+    }
+    for (int i = 0; i < num_frame_buffers; i++) {
+        spi_strip->frame_bufs[i] = buffers + i * frame_stride;
+    }
+    spi_strip->num_frame_buffers = num_frame_buffers;
+    if (led_config->pixel_buf) {
+        spi_strip->frame_bufs[0] = led_config->pixel_buf;
+    }
+    spi_strip->pixel_buf = spi_strip->frame_bufs[0];
+    if (streaming) {
+        spi_strip->num_stream_chunks = num_stream_chunks;
+        spi_strip->stream_chunk_size = stream_chunk_size;
+        for (int i = 0; i < num_stream_chunks; i++) {
+            // DMA buffer must be placed in internal SRAM
+            spi_strip->stream_chunks[i] = heap_caps_calloc(1, max_transfer_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+            ESP_GOTO_ON_FALSE(spi_strip->stream_chunks[i], ESP_ERR_NO_MEM, err, TAG, "no mem for spi stream chunk");
+        }
+    }
+
+    spi_strip->spi_host = spi_config->spi_bus;
+    // for backward compatibility, if the user does not set the clk_src, use the default value
+    spi_clock_source_t clk_src = SPI_CLK_SRC_DEFAULT;
+    if (spi_config->clk_src) {
+        clk_src = spi_config->clk_src;
+    }
+
+    spi_bus_config_t spi_bus_cfg = {
+        .mosi_io_num = led_config->strip_gpio_num,
+        //Only use MOSI to generate the signal, set -1 when other pins are not used.
+        .miso_io_num = -1,
+        .sclk_io_num = -1,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = max_transfer_size,
+    };
+    ESP_GOTO_ON_ERROR(spi_bus_initialize(spi_strip->spi_host, &spi_bus_cfg, spi_config->flags.with_dma ? SPI_DMA_CH_AUTO : SPI_DMA_DISABLED), err, TAG, "create SPI bus failed");
+
+    if (led_config->flags.invert_out == true) {
+        esp_rom_gpio_connect_out_signal(led_config->strip_gpio_num, spi_periph_signal[spi_strip->spi_host].spid_out, true, false);
+    }
+
+    spi_device_interface_config_t spi_dev_cfg = {
+        .clock_source = clk_src,
+        .command_bits = 0,
+        .address_bits = 0,
+        .dummy_bits = 0,
+        .clock_speed_hz = LED_STRIP_SPI_DEFAULT_RESOLUTION,
+        .mode = 0,
+        //set -1 when CS is not used
+        .spics_io_num = -1,
+        .queue_size = LED_STRIP_SPI_DEFAULT_TRANS_QUEUE_SIZE,
+        .post_cb = led_strip_spi_post_trans_cb,
+    };
+
+    ESP_GOTO_ON_ERROR(spi_bus_add_device(spi_strip->spi_host, &spi_dev_cfg, &spi_strip->spi_device), err, TAG, "Failed to add spi device");
+    //ensure the reset time is enough
+    esp_rom_delay_us(10);
+    int clock_resolution_khz = 0;
+    spi_device_get_actual_freq(spi_strip->spi_device, &clock_resolution_khz);
+    // TODO: ideally we should decide the SPI_BYTES_PER_COLOR_BYTE by the real clock resolution
+    // But now, let's fixed the resolution, the downside is, we don't support a clock source whose frequency is not multiple of LED_STRIP_SPI_DEFAULT_RESOLUTION
+    // clock_resolution between 2.2MHz to 2.8MHz is supported
+    ESP_GOTO_ON_FALSE((clock_resolution_khz < LED_STRIP_SPI_DEFAULT_RESOLUTION / 1000 + 300) && (clock_resolution_khz > LED_STRIP_SPI_DEFAULT_RESOLUTION / 1000 - 300), ESP_ERR_NOT_SUPPORTED, err,
+                      TAG, "unsupported clock resolution:%dKHz", clock_resolution_khz);
+
+    spi_strip->bytes_per_pixel = bytes_per_pixel;
+    spi_strip->strip_len = led_config->max_leds;
+    spi_strip->active_len = led_config->max_leds;
+    spi_strip->sent_len = led_config->max_leds;
+    spi_strip->base.set_pixel = led_strip_spi_set_pixel;
+    spi_strip->base.set_pixel_rgbw = led_strip_spi_set_pixel_rgbw;
+    spi_strip->base.set_pixels = led_strip_spi_set_pixels;
+    spi_strip->base.fill = led_strip_spi_fill;
+    spi_strip->base.write_frame = led_strip_spi_write_frame;
+    spi_strip->base.set_active_length = led_strip_spi_set_active_length;
+    spi_strip->base.refresh = led_strip_spi_refresh;
+    // with a single frame buffer there is nothing to draw into while a frame is sent, `led_strip_refresh_async` falls back to `refresh`
+    spi_strip->base.refresh_async = num_frame_buffers > 1 ? led_strip_spi_refresh_async : NULL;
+    spi_strip->base.wait_refresh_done = num_frame_buffers > 1 ? led_strip_spi_wait_refresh_done : NULL;
+    spi_strip->base.register_event_callbacks = led_strip_spi_register_event_callbacks;
+    spi_strip->base.get_event_callbacks = led_strip_spi_get_event_callbacks;
+    spi_strip->base.clear = led_strip_spi_clear;
+    spi_strip->base.get_mem_report = led_strip_spi_get_mem_report;
+    spi_strip->base.del = led_strip_spi_del;
+    if (streaming) {
+        spi_strip->base.set_pixel = led_strip_spi_stream_set_pixel;
+        spi_strip->base.set_pixel_rgbw = led_strip_spi_stream_set_pixel_rgbw;
+        spi_strip->base.set_pixels = led_strip_spi_stream_set_pixels;
+        spi_strip->base.fill = led_strip_spi_stream_fill;
+        spi_strip->base.write_frame = led_strip_spi_stream_write_frame;
+        spi_strip->base.get_buffer = led_strip_spi_stream_get_buffer;
+        spi_strip->base.refresh = led_strip_spi_stream_refresh;
+        // the stream refresh only returns after the last chunk is sent out
+        spi_strip->base.refresh_async = NULL;
+        spi_strip->base.wait_refresh_done = NULL;
+        spi_strip->base.clear = led_strip_spi_stream_clear;
+    }
+
+    *ret_strip = &spi_strip->base;
+    return ESP_OK;
+err:
+    if (spi_strip) {
+        if (spi_strip->spi_device) {
+            spi_bus_remove_device(spi_strip->spi_device);
+        }
+        if (spi_strip->spi_host) {
+            spi_bus_free(spi_strip->spi_host);
+        }
+        for (int i = 0; i < LED_STRIP_SPI_MAX_STREAM_CHUNKS; i++) {
+            free(spi_strip->stream_chunks[i]);
+        }
+        free(spi_strip->ext_buffers);
+        free(spi_strip);
+    }
+    return ret;
+}
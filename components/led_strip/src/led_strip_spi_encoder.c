@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "led_strip_spi_encoder.h"
+
+// Each color of 1 bit is represented by 3 bits of SPI, low_level:100 ,high_level:110
+// So a color byte occupies 3 bytes of SPI, this table holds the encoding of every possible color byte (MSB first)
+const uint8_t led_strip_spi_lut[256][SPI_BYTES_PER_COLOR_BYTE] = {
+    {0x92, 0x49, 0x24}, {0x92, 0x49, 0x26}, {0x92, 0x49, 0x34}, {0x92, 0x49, 0x36},
+    {0x92, 0x49, 0xA4}, {0x92, 0x49, 0xA6}, {0x92, 0x49, 0xB4}, {0x92, 0x49, 0xB6},
+    {0x92, 0x4D, 0x24}, {0x92, 0x4D, 0x26}, {0x92, 0x4D, 0x34}, {0x92, 0x4D, 0x36},
+    {0x92, 0x4D, 0xA4}, {0x92, 0x4D, 0xA6}, {0x92, 0x4D, 0xB4}, {0x92, 0x4D, 0xB6},
+    {0x92, 0x69, 0x24}, {0x92, 0x69, 0x26}, {0x92, 0x69, 0x34}, {0x92, 0x69, 0x36},
+    {0x92, 0x69, 0xA4}, {0x92, 0x69, 0xA6}, {0x92, 0x69, 0xB4}, {0x92, 0x69, 0xB6},
+    {0x92, 0x6D, 0x24}, {0x92, 0x6D, 0x26}, {0x92, 0x6D, 0x34}, {0x92, 0x6D, 0x36},
+    {0x92, 0x6D, 0xA4}, {0x92, 0x6D, 0xA6}, {0x92, 0x6D, 0xB4}, {0x92, 0x6D, 0xB6},
+    {0x93, 0x49, 0x24}, {0x93, 0x49, 0x26}, {0x93, 0x49, 0x34}, {0x93, 0x49, 0x36},
+    {0x93, 0x49, 0xA4}, {0x93, 0x49, 0xA6}, {0x93, 0x49, 0xB4}, {0x93, 0x49, 0xB6},
+    {0x93, 0x4D, 0x24}, {0x93, 0x4D, 0x26}, {0x93, 0x4D, 0x34}, {0x93, 0x4D, 0x36},
+    {0x93, 0x4D, 0xA4}, {0x93, 0x4D, 0xA6}, {0x93, 0x4D, 0xB4}, {0x93, 0x4D, 0xB6},
+    {0x93, 0x69, 0x24}, {0x93, 0x69, 0x26}, {0x93, 0x69, 0x34}, {0x93, 0x69, 0x36},
+    {0x93, 0x69, 0xA4}, {0x93, 0x69, 0xA6}, {0x93, 0x69, 0xB4}, {0x93, 0x69, 0xB6},
+    {0x93, 0x6D, 0x24}, {0x93, 0x6D, 0x26}, {0x93, 0x6D, 0x34}, {0x93, 0x6D, 0x36},
+    {0x93, 0x6D, 0xA4}, {0x93, 0x6D, 0xA6}, {0x93, 0x6D, 0xB4}, {0x93, 0x6D, 0xB6},
+    {0x9A, 0x49, 0x24}, {0x9A, 0x49, 0x26}, {0x9A, 0x49, 0x34}, {0x9A, 0x49, 0x36},
+    {0x9A, 0x49, 0xA4}, {0x9A, 0x49, 0xA6}, {0x9A, 0x49, 0xB4}, {0x9A, 0x49, 0xB6},
+    {0x9A, 0x4D, 0x24}, {0x9A, 0x4D, 0x26}, {0x9A, 0x4D, 0x34}, {0x9A, 0x4D, 0x36},
+    {0x9A, 0x4D, 0xA4}, {0x9A, 0x4D, 0xA6}, {0x9A, 0x4D, 0xB4}, {0x9A, 0x4D, 0xB6},
+    {0x9A, 0x69, 0x24}, {0x9A, 0x69, 0x26}, {0x9A, 0x69, 0x34}, {0x9A, 0x69, 0x36},
+    {0x9A, 0x69, 0xA4}, {0x9A, 0x69, 0xA6}, {0x9A, 0x69, 0xB4}, {0x9A, 0x69, 0xB6},
+    {0x9A, 0x6D, 0x24}, {0x9A, 0x6D, 0x26}, {0x9A, 0x6D, 0x34}, {0x9A, 0x6D, 0x36},
+    {0x9A, 0x6D, 0xA4}, {0x9A, 0x6D, 0xA6}, {0x9A, 0x6D, 0xB4}, {0x9A, 0x6D, 0xB6},
+    {0x9B, 0x49, 0x24}, {0x9B, 0x49, 0x26}, {0x9B, 0x49, 0x34}, {0x9B, 0x49, 0x36},
+    {0x9B, 0x49, 0xA4}, {0x9B, 0x49, 0xA6}, {0x9B, 0x49, 0xB4}, {0x9B, 0x49, 0xB6},
+    {0x9B, 0x4D, 0x24}, {0x9B, 0x4D, 0x26}, {0x9B, 0x4D, 0x34}, {0x9B, 0x4D, 0x36},
+    {0x9B, 0x4D, 0xA4}, {0x9B, 0x4D, 0xA6}, {0x9B, 0x4D, 0xB4}, {0x9B, 0x4D, 0xB6},
+    {0x9B, 0x69, 0x24}, {0x9B, 0x69, 0x26}, {0x9B, 0x69, 0x34}, {0x9B, 0x69, 0x36},
+    {0x9B, 0x69, 0xA4}, {0x9B, 0x69, 0xA6}, {0x9B, 0x69, 0xB4}, {0x9B, 0x69, 0xB6},
+    {0x9B, 0x6D, 0x24}, {0x9B, 0x6D, 0x26}, {0x9B, 0x6D, 0x34}, {0x9B, 0x6D, 0x36},
+    {0x9B, 0x6D, 0xA4}, {0x9B, 0x6D, 0xA6}, {0x9B, 0x6D, 0xB4}, {0x9B, 0x6D, 0xB6},
+    {0xD2, 0x49, 0x24}, {0xD2, 0x49, 0x26}, {0xD2, 0x49, 0x34}, {0xD2, 0x49, 0x36},
+    {0xD2, 0x49, 0xA4}, {0xD2, 0x49, 0xA6}, {0xD2, 0x49, 0xB4}, {0xD2, 0x49, 0xB6},
+    {0xD2, 0x4D, 0x24}, {0xD2, 0x4D, 0x26}, {0xD2, 0x4D, 0x34}, {0xD2, 0x4D, 0x36},
+    {0xD2, 0x4D, 0xA4}, {0xD2, 0x4D, 0xA6}, {0xD2, 0x4D, 0xB4}, {0xD2, 0x4D, 0xB6},
+    {0xD2, 0x69, 0x24}, {0xD2, 0x69, 0x26}, {0xD2, 0x69, 0x34}, {0xD2, 0x69, 0x36},
+    {0xD2, 0x69, 0xA4}, {0xD2, 0x69, 0xA6}, {0xD2, 0x69, 0xB4}, {0xD2, 0x69, 0xB6},
+    {0xD2, 0x6D, 0x24}, {0xD2, 0x6D, 0x26}, {0xD2, 0x6D, 0x34}, {0xD2, 0x6D, 0x36},
+    {0xD2, 0x6D, 0xA4}, {0xD2, 0x6D, 0xA6}, {0xD2, 0x6D, 0xB4}, {0xD2, 0x6D, 0xB6},
+    {0xD3, 0x49, 0x24}, {0xD3, 0x49, 0x26}, {0xD3, 0x49, 0x34}, {0xD3, 0x49, 0x36},
+    {0xD3, 0x49, 0xA4}, {0xD3, 0x49, 0xA6}, {0xD3, 0x49, 0xB4}, {0xD3, 0x49, 0xB6},
+    {0xD3, 0x4D, 0x24}, {0xD3, 0x4D, 0x26}, {0xD3, 0x4D, 0x34}, {0xD3, 0x4D, 0x36},
+    {0xD3, 0x4D, 0xA4}, {0xD3, 0x4D, 0xA6}, {0xD3, 0x4D, 0xB4}, {0xD3, 0x4D, 0xB6},
+    {0xD3, 0x69, 0x24}, {0xD3, 0x69, 0x26}, {0xD3, 0x69, 0x34}, {0xD3, 0x69, 0x36},
+    {0xD3, 0x69, 0xA4}, {0xD3, 0x69, 0xA6}, {0xD3, 0x69, 0xB4}, {0xD3, 0x69, 0xB6},
+    {0xD3, 0x6D, 0x24}, {0xD3, 0x6D, 0x26}, {0xD3, 0x6D, 0x34}, {0xD3, 0x6D, 0x36},
+    {0xD3, 0x6D, 0xA4}, {0xD3, 0x6D, 0xA6}, {0xD3, 0x6D, 0xB4}, {0xD3, 0x6D, 0xB6},
+    {0xDA, 0x49, 0x24}, {0xDA, 0x49, 0x26}, {0xDA, 0x49, 0x34}, {0xDA, 0x49, 0x36},
+    {0xDA, 0x49, 0xA4}, {0xDA, 0x49, 0xA6}, {0xDA, 0x49, 0xB4}, {0xDA, 0x49, 0xB6},
+    {0xDA, 0x4D, 0x24}, {0xDA, 0x4D, 0x26}, {0xDA, 0x4D, 0x34}, {0xDA, 0x4D, 0x36},
+    {0xDA, 0x4D, 0xA4}, {0xDA, 0x4D, 0xA6}, {0xDA, 0x4D, 0xB4}, {0xDA, 0x4D, 0xB6},
+    {0xDA, 0x69, 0x24}, {0xDA, 0x69, 0x26}, {0xDA, 0x69, 0x34}, {0xDA, 0x69, 0x36},
+    {0xDA, 0x69, 0xA4}, {0xDA, 0x69, 0xA6}, {0xDA, 0x69, 0xB4}, {0xDA, 0x69, 0xB6},
+    {0xDA, 0x6D, 0x24}, {0xDA, 0x6D, 0x26}, {0xDA, 0x6D, 0x34}, {0xDA, 0x6D, 0x36},
+    {0xDA, 0x6D, 0xA4}, {0xDA, 0x6D, 0xA6}, {0xDA, 0x6D, 0xB4}, {0xDA, 0x6D, 0xB6},
+    {0xDB, 0x49, 0x24}, {0xDB, 0x49, 0x26}, {0xDB, 0x49, 0x34}, {0xDB, 0x49, 0x36},
+    {0xDB, 0x49, 0xA4}, {0xDB, 0x49, 0xA6}, {0xDB, 0x49, 0xB4}, {0xDB, 0x49, 0xB6},
+    {0xDB, 0x4D, 0x24}, {0xDB, 0x4D, 0x26}, {0xDB, 0x4D, 0x34}, {0xDB, 0x4D, 0x36},
+    {0xDB, 0x4D, 0xA4}, {0xDB, 0x4D, 0xA6}, {0xDB, 0x4D, 0xB4}, {0xDB, 0x4D, 0xB6},
+    {0xDB, 0x69, 0x24}, {0xDB, 0x69, 0x26}, {0xDB, 0x69, 0x34}, {0xDB, 0x69, 0x36},
+    {0xDB, 0x69, 0xA4}, {0xDB, 0x69, 0xA6}, {0xDB, 0x69, 0xB4}, {0xDB, 0x69, 0xB6},
+    {0xDB, 0x6D, 0x24}, {0xDB, 0x6D, 0x26}, {0xDB, 0x6D, 0x34}, {0xDB, 0x6D, 0x36},
+    {0xDB, 0x6D, 0xA4}, {0xDB, 0x6D, 0xA6}, {0xDB, 0x6D, 0xB4}, {0xDB, 0x6D, 0xB6},
+};
+
+void led_strip_spi_encode(const uint8_t *src, size_t size, uint8_t *dst)
+{
+    for (size_t i = 0; i < size; i++) {
+        led_strip_spi_encode_byte(src[i], dst);
+        dst += SPI_BYTES_PER_COLOR_BYTE;
+    }
+}
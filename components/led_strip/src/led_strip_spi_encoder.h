@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of SPI bytes that one color byte is expanded to
+ */
+#define SPI_BYTES_PER_COLOR_BYTE 3
+
+/**
+ * @brief SPI encoding of every possible color byte
+ *
+ * Each color of 1 bit is represented by 3 bits of SPI, low_level:100 ,high_level:110, MSB first.
+ */
+extern const uint8_t led_strip_spi_lut[256][SPI_BYTES_PER_COLOR_BYTE];
+
+/**
+ * @brief Encode one color byte into SPI_BYTES_PER_COLOR_BYTE bytes of SPI waveform
+ *
+ * @param[in] data Color byte
+ * @param[out] buf Buffer of at least SPI_BYTES_PER_COLOR_BYTE bytes
+ */
+static inline void led_strip_spi_encode_byte(uint8_t data, uint8_t *buf)
+{
+    memcpy(buf, led_strip_spi_lut[data], SPI_BYTES_PER_COLOR_BYTE);
+}
+
+/**
+ * @brief Encode color bytes into SPI waveform
+ *
+ * @param[in] src Color bytes
+ * @param[in] size Number of color bytes
+ * @param[out] dst Buffer of at least size * SPI_BYTES_PER_COLOR_BYTE bytes
+ */
+void led_strip_spi_encode(const uint8_t *src, size_t size, uint8_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,28 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stddef.h>
+#include "led_strip_timing.h"
+
+// Timings of the one-wire models, taken from the datasheets, all the models send the bits MSB first.
+// The clocked models (APA102, SK9822) have no entry, their bits are latched by the clock line.
+// WS2812 and SK6812 keep the 280us reset that the driver always used, to accommodate WS2812B-V5.
+// WS2813 needs at least 300us to latch
+static const led_strip_timing_t s_led_strip_timings[LED_MODEL_INVALID] = {
+    [LED_MODEL_WS2812] = {.t0h_ns = 300, .t0l_ns = 900, .t1h_ns = 900, .t1l_ns = 300, .reset_us = 280},
+    [LED_MODEL_SK6812] = {.t0h_ns = 300, .t0l_ns = 900, .t1h_ns = 600, .t1l_ns = 600, .reset_us = 280},
+    [LED_MODEL_WS2811] = {.t0h_ns = 250, .t0l_ns = 1000, .t1h_ns = 600, .t1l_ns = 650, .reset_us = 280}, // high speed mode (800KHz)
+    [LED_MODEL_WS2813] = {.t0h_ns = 300, .t0l_ns = 900, .t1h_ns = 800, .t1l_ns = 400, .reset_us = 300},
+    [LED_MODEL_WS2815] = {.t0h_ns = 300, .t0l_ns = 900, .t1h_ns = 900, .t1l_ns = 300, .reset_us = 280},
+    [LED_MODEL_APA106] = {.t0h_ns = 350, .t0l_ns = 1360, .t1h_ns = 1360, .t1l_ns = 350, .reset_us = 80},
+};
+
+const led_strip_timing_t *led_strip_get_timing(led_model_t model)
+{
+    if (model >= LED_MODEL_INVALID || s_led_strip_timings[model].t0h_ns == 0) {
+        return NULL;
+    }
+    return &s_led_strip_timings[model];
+}
@@ -0,0 +1,48 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Timing of the bits and the reset code of a LED model
+ */
+typedef struct {
+    uint16_t t0h_ns;   /*!< High time of bit 0, in ns */
+    uint16_t t0l_ns;   /*!< Low time of bit 0, in ns */
+    uint16_t t1h_ns;   /*!< High time of bit 1, in ns */
+    uint16_t t1l_ns;   /*!< Low time of bit 1, in ns */
+    uint16_t reset_us; /*!< Default low time that latches the frame, in us */
+} led_strip_timing_t;
+
+/**
+ * @brief Get the timing of a LED model
+ *
+ * @param[in] model LED model
+ * @return Timing of the model, or NULL if the model is invalid or isn't a one-wire LED
+ */
+const led_strip_timing_t *led_strip_get_timing(led_model_t model);
+
+/**
+ * @brief Convert a duration into ticks of the given resolution
+ *
+ * @param[in] ns Duration, in ns
+ * @param[in] resolution_hz Tick resolution, in Hz
+ * @return Number of ticks, rounded down
+ */
+static inline uint32_t led_strip_ns_to_ticks(uint32_t ns, uint32_t resolution_hz)
+{
+    return (uint64_t)ns * resolution_hz / 1000000000;
+}
+
+#ifdef __cplusplus
+}
+#endif
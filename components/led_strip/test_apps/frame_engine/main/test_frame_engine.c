@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "unity.h"
+#include "led_strip.h"
+
+#define TEST_LEDS     16
+#define TEST_FPS      100
+// long enough for a few tens of frames at TEST_FPS
+#define TEST_RUN_MS   500
+
+typedef struct {
+    uint32_t rendered;   // render callback calls
+    uint32_t changed;    // frames reported as changed
+    uint32_t last_frame; // index of the last frame reported as changed
+    bool skip_odd;       // report the odd frames as unchanged
+} test_render_ctx_t;
+
+static bool test_render(led_strip_handle_t strip, uint32_t frame, void *user_ctx)
+{
+    test_render_ctx_t *ctx = (test_render_ctx_t *)user_ctx;
+    ctx->rendered++;
+    if (ctx->skip_odd && (frame & 1)) {
+        return false;
+    }
+    ctx->changed++;
+    ctx->last_frame = frame;
+    // the frame index goes into the red component, so the strip tells which frame it holds
+    led_strip_fill(strip, 0, TEST_LEDS, frame & 0xFF, 0, 0);
+    return true;
+}
+
+static led_strip_handle_t test_new_capture_strip(void)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = TEST_LEDS,
+        .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+        .led_model = LED_MODEL_WS2812,
+    };
+    led_strip_capture_config_t capture_config = {
+        .waveform = LED_STRIP_CAPTURE_WAVEFORM_RMT,
+    };
+    led_strip_handle_t strip = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_new_capture_device(&strip_config, &capture_config, &strip));
+    return strip;
+}
+
+// run the engine for TEST_RUN_MS and return its counters
+static void test_run_engine(led_strip_handle_t strip, test_render_ctx_t *ctx, led_strip_frame_engine_stats_t *ret_stats)
+{
+    led_strip_frame_engine_config_t engine_config = {
+        .strip = strip,
+        .fps = TEST_FPS,
+        .on_render = test_render,
+        .user_ctx = ctx,
+    };
+    led_strip_frame_engine_handle_t engine = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_new_frame_engine(&engine_config, &engine));
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_frame_engine_start(engine));
+    vTaskDelay(pdMS_TO_TICKS(TEST_RUN_MS));
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_frame_engine_stop(engine));
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_frame_engine_get_stats(engine, ret_stats));
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_del_frame_engine(engine));
+}
+
+static void test_frame_engine_refreshes_every_frame(void)
+{
+    led_strip_handle_t strip = test_new_capture_strip();
+    test_render_ctx_t ctx = {};
+    led_strip_frame_engine_stats_t stats = {};
+    test_run_engine(strip, &ctx, &stats);
+
+    // the capture strip has no asynchronous refresh, each frame went through one blocking refresh
+    uint32_t frame_count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_capture_get_frame_count(strip, &frame_count));
+    TEST_ASSERT_TRUE(ctx.changed >= TEST_FPS * TEST_RUN_MS / 1000 / 2);
+    TEST_ASSERT_EQUAL(ctx.changed, stats.frames);
+    TEST_ASSERT_EQUAL(stats.frames, frame_count);
+    TEST_ASSERT_EQUAL(0, stats.skipped);
+    // without a refresh done event the transmit time is the blocking refresh, so it can't exceed the whole run
+    TEST_ASSERT_LESS_OR_EQUAL(TEST_RUN_MS * 1000, stats.transmit_max_us);
+
+    uint8_t *buf = NULL;
+    size_t size = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_get_buffer(strip, &buf, &size));
+    TEST_ASSERT_EQUAL(ctx.last_frame & 0xFF, buf[1]);
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_del(strip));
+}
+
+static void test_frame_engine_skips_unchanged_frames(void)
+{
+    led_strip_handle_t strip = test_new_capture_strip();
+    test_render_ctx_t ctx = {
+        .skip_odd = true,
+    };
+    led_strip_frame_engine_stats_t stats = {};
+    test_run_engine(strip, &ctx, &stats);
+
+    uint32_t frame_count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_capture_get_frame_count(strip, &frame_count));
+    TEST_ASSERT_TRUE(stats.skipped > 0);
+    TEST_ASSERT_EQUAL(ctx.rendered, stats.frames + stats.skipped);
+    TEST_ASSERT_EQUAL(ctx.changed, frame_count);
+    TEST_ASSERT_EQUAL(stats.frames, frame_count);
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_del(strip));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_engine_refreshes_every_frame);
+    RUN_TEST(test_frame_engine_skips_unchanged_frames);
+    UNITY_END();
+}
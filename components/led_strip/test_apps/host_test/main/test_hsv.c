@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include "unity.h"
+#include "led_strip.h"
+#include "test_led_strip_host.h"
+
+#define TEST_HSV_HUES 360
+
+// The float conversion that the integer kernel replaced, kept as the reference
+static void test_hsv2rgb_float(uint16_t hue, uint8_t saturation, uint8_t value, uint8_t *rgb)
+{
+    uint32_t red = 0;
+    uint32_t green = 0;
+    uint32_t blue = 0;
+
+    uint32_t rgb_max = value;
+    uint32_t rgb_min = rgb_max * (255 - saturation) / 255.0f;
+
+    uint32_t i = hue / 60;
+    uint32_t diff = hue % 60;
+
+    // RGB adjustment amount by hue
+    uint32_t rgb_adj = (rgb_max - rgb_min) * diff / 60;
+
+    switch (i) {
+    case 0:
+        red = rgb_max;
+        green = rgb_min + rgb_adj;
+        blue = rgb_min;
+        break;
+    case 1:
+        red = rgb_max - rgb_adj;
+        green = rgb_max;
+        blue = rgb_min;
+        break;
+    case 2:
+        red = rgb_min;
+        green = rgb_max;
+        blue = rgb_min + rgb_adj;
+        break;
+    case 3:
+        red = rgb_min;
+        green = rgb_max - rgb_adj;
+        blue = rgb_max;
+        break;
+    case 4:
+        red = rgb_min + rgb_adj;
+        green = rgb_min;
+        blue = rgb_max;
+        break;
+    default:
+        red = rgb_max;
+        green = rgb_min;
+        blue = rgb_max - rgb_adj;
+        break;
+    }
+    rgb[0] = red;
+    rgb[1] = green;
+    rgb[2] = blue;
+}
+
+// largest difference of any component between a GRB pixel in the strip and the reference conversion
+static int test_hsv_error(const uint8_t *grb, uint16_t hue, uint8_t saturation, uint8_t value)
+{
+    uint8_t rgb[3];
+    test_hsv2rgb_float(hue, saturation, value, rgb);
+    int error = 0;
+    const int diffs[3] = {grb[1] - rgb[0], grb[0] - rgb[1], grb[2] - rgb[2]};
+    for (int i = 0; i < 3; i++) {
+        int diff = abs(diffs[i]);
+        error = diff > error ? diff : error;
+    }
+    return error;
+}
+
+static led_strip_handle_t test_hsv_new_strip(uint32_t leds)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = leds,
+        .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+        .led_model = LED_MODEL_WS2812,
+    };
+    led_strip_capture_config_t capture_config = {
+        .waveform = LED_STRIP_CAPTURE_WAVEFORM_RMT,
+    };
+    led_strip_handle_t strip = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_new_capture_device(&strip_config, &capture_config, &strip));
+    return strip;
+}
+
+// every hue of the color wheel at every saturation and value, through the batched writer
+static void test_hsv_matches_float_all_colors(void)
+{
+    led_strip_handle_t strip = test_hsv_new_strip(TEST_HSV_HUES);
+    led_color_hsv_t *hsv = malloc(TEST_HSV_HUES * sizeof(led_color_hsv_t));
+    TEST_ASSERT_TRUE(hsv);
+    uint8_t *buf = NULL;
+    size_t size = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_get_buffer(strip, &buf, &size));
+    int max_error = 0;
+    for (int saturation = 0; saturation < 256; saturation++) {
+        for (int value = 0; value < 256; value++) {
+            for (int hue = 0; hue < TEST_HSV_HUES; hue++) {
+                hsv[hue] = (led_color_hsv_t) {
+                    .hue = hue, .saturation = saturation, .value = value
+                };
+            }
+            TEST_ASSERT_EQUAL(ESP_OK, led_strip_set_pixels_hsv(strip, 0, TEST_HSV_HUES, hsv));
+            for (int hue = 0; hue < TEST_HSV_HUES; hue++) {
+                int error = test_hsv_error(&buf[hue * 3], hue, saturation, value);
+                max_error = error > max_error ? error : max_error;
+            }
+        }
+    }
+    free(hsv);
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_del(strip));
+    TEST_ASSERT_EQUAL_MESSAGE(0, max_error, "integer kernel differs from the float conversion");
+}
+
+// the whole 16-bit hue range, past the color wheel, at sampled saturations and values, through the single pixel writer
+static void test_hsv_matches_float_all_hues(void)
+{
+    led_strip_handle_t strip = test_hsv_new_strip(1);
+    uint8_t *buf = NULL;
+    size_t size = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_get_buffer(strip, &buf, &size));
+    int max_error = 0;
+    for (int saturation = 0; saturation < 256; saturation += 51) {
+        for (int value = 0; value < 256; value += 15) {
+            for (uint32_t hue = 0; hue <= UINT16_MAX; hue++) {
+                TEST_ASSERT_EQUAL(ESP_OK, led_strip_set_pixel_hsv(strip, 0, hue, saturation, value));
+                int error = test_hsv_error(buf, hue, saturation, value);
+                max_error = error > max_error ? error : max_error;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_del(strip));
+    TEST_ASSERT_EQUAL_MESSAGE(0, max_error, "integer kernel differs from the float conversion");
+}
+
+void test_hsv_run(void)
+{
+    RUN_TEST(test_hsv_matches_float_all_colors);
+    RUN_TEST(test_hsv_matches_float_all_hues);
+}
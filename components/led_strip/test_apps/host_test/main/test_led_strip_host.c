@@ -0,0 +1,26 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdlib.h>
+#include "unity.h"
+#include "test_led_strip_host.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    test_spi_encoder_run();
+    test_hsv_run();
+    test_nibble_symbols_run();
+    // the exit code tells a CI job whether the tests passed
+    exit(UNITY_END());
+}
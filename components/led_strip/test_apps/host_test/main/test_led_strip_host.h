@@ -0,0 +1,11 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#pragma once
+
+// Every test file runs its own cases with RUN_TEST, between the UNITY_BEGIN and UNITY_END of app_main
+void test_spi_encoder_run(void);
+void test_hsv_run(void);
+void test_nibble_symbols_run(void);
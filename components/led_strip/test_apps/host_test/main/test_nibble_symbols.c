@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include "unity.h"
+#include "led_strip.h"
+#include "led_strip_encoding.h"
+#include "led_strip_timing.h"
+#include "test_led_strip_host.h"
+
+// counter clock of the IDF4 RMT backend: 80MHz APB clock divided by 2
+#define TEST_IDF4_COUNTER_CLK_HZ (40 * 1000 * 1000)
+
+// Bit durations in ticks: high and low time of a 0 bit, then of a 1 bit
+typedef struct {
+    uint16_t t0h;
+    uint16_t t0l;
+    uint16_t t1h;
+    uint16_t t1l;
+} test_bit_ticks_t;
+
+// The datasheet timings of every one-wire model counted in 25ns ticks of the IDF4 counter clock, rounded down,
+// written out by hand so that a wrong timing entry or tick conversion can't hide in the expected values
+static const test_bit_ticks_t s_idf4_bit_ticks[LED_MODEL_INVALID] = {
+    [LED_MODEL_WS2812] = {.t0h = 12, .t0l = 36, .t1h = 36, .t1l = 12}, // 300ns/900ns, 900ns/300ns
+    [LED_MODEL_SK6812] = {.t0h = 12, .t0l = 36, .t1h = 24, .t1l = 24}, // 300ns/900ns, 600ns/600ns
+    [LED_MODEL_WS2811] = {.t0h = 10, .t0l = 40, .t1h = 24, .t1l = 26}, // 250ns/1000ns, 600ns/650ns
+    [LED_MODEL_WS2813] = {.t0h = 12, .t0l = 36, .t1h = 32, .t1l = 16}, // 300ns/900ns, 800ns/400ns
+    [LED_MODEL_WS2815] = {.t0h = 12, .t0l = 36, .t1h = 36, .t1l = 12}, // 300ns/900ns, 900ns/300ns
+    [LED_MODEL_APA106] = {.t0h = 14, .t0l = 54, .t1h = 54, .t1l = 14}, // 350ns/1360ns, 1360ns/350ns
+};
+
+// SK6812 counted in 100ns ticks of the capture backend, which records at 10MHz by default
+static const test_bit_ticks_t s_sk6812_capture_bit_ticks = {.t0h = 3, .t0l = 9, .t1h = 6, .t1l = 6};
+
+// The bit by bit adapter of the IDF4 RMT backend that the nibble table replaced, kept as the reference
+static void test_bit_adapter(const test_bit_ticks_t *ticks, const uint8_t *src, size_t src_size, uint32_t *dest)
+{
+    const led_strip_capture_symbol_t bit0 = {{ ticks->t0h, 1, ticks->t0l, 0 }}; //Logical 0
+    const led_strip_capture_symbol_t bit1 = {{ ticks->t1h, 1, ticks->t1l, 0 }}; //Logical 1
+    for (size_t size = 0; size < src_size; size++) {
+        for (int i = 0; i < 8; i++) {
+            // MSB first
+            if (src[size] & (1 << (7 - i))) {
+                *dest = bit1.val;
+            } else {
+                *dest = bit0.val;
+            }
+            dest++;
+        }
+    }
+}
+
+// every color byte expanded with the nibble table, for the timing of every LED model
+static void test_nibble_table_matches_bit_adapter(void)
+{
+    for (int model = 0; model < LED_MODEL_INVALID; model++) {
+        const led_strip_timing_t *timing = led_strip_get_timing(model);
+        if (!timing) {
+            continue;
+        }
+        TEST_ASSERT_NOT_EQUAL_MESSAGE(0, s_idf4_bit_ticks[model].t0h, "no expected ticks for the model");
+        uint32_t bit0 = 0;
+        uint32_t bit1 = 0;
+        uint32_t table[16][4];
+        led_strip_get_bit_symbols(timing, TEST_IDF4_COUNTER_CLK_HZ, &bit0, &bit1);
+        led_strip_build_nibble_symbols(bit0, bit1, table);
+        for (int data = 0; data < 256; data++) {
+            uint8_t byte = data;
+            uint32_t expected[8];
+            uint32_t encoded[8];
+            test_bit_adapter(&s_idf4_bit_ticks[model], &byte, 1, expected);
+            led_strip_encode_byte_symbols(table, byte, encoded);
+            TEST_ASSERT_EQUAL_HEX32_ARRAY_MESSAGE(expected, encoded, 8, "color byte expanded differently");
+        }
+    }
+}
+
+// the RMT symbols captured for a frame holding every color byte, followed by the reset code
+static void test_capture_symbols_match_bit_adapter(void)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = 64,
+        .led_pixel_format = LED_PIXEL_FORMAT_GRBW,
+        .led_model = LED_MODEL_SK6812,
+    };
+    led_strip_capture_config_t capture_config = {
+        .waveform = LED_STRIP_CAPTURE_WAVEFORM_RMT,
+    };
+    led_strip_handle_t strip = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_new_capture_device(&strip_config, &capture_config, &strip));
+    uint8_t frame[64 * 4];
+    for (int i = 0; i < sizeof(frame); i++) {
+        frame[i] = i * 167;
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_write_frame(strip, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_refresh(strip));
+
+    const led_strip_capture_symbol_t *symbols = NULL;
+    size_t num_symbols = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_capture_get_symbols(strip, &symbols, &num_symbols));
+    TEST_ASSERT_EQUAL(sizeof(frame) * 8 + 1, num_symbols);
+    static uint32_t expected[sizeof(frame) * 8];
+    test_bit_adapter(&s_sk6812_capture_bit_ticks, frame, sizeof(frame), expected);
+    TEST_ASSERT_EQUAL_HEX32_ARRAY(expected, (const uint32_t *)symbols, sizeof(frame) * 8);
+    // 280us low in 100ns ticks, split into the two halves of the symbol
+    const led_strip_capture_symbol_t reset_code = {{ 1400, 0, 1400, 0 }};
+    TEST_ASSERT_EQUAL(reset_code.val, symbols[num_symbols - 1].val);
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_del(strip));
+}
+
+void test_nibble_symbols_run(void)
+{
+    RUN_TEST(test_nibble_table_matches_bit_adapter);
+    RUN_TEST(test_capture_symbols_match_bit_adapter);
+}
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <string.h>
+#include "unity.h"
+#include "esp_bit_defs.h"
+#include "led_strip.h"
+#include "led_strip_spi_encoder.h"
+#include "test_led_strip_host.h"
+
+// The bit by bit encoder that the lookup table replaced, kept as the reference
+static void __led_strip_spi_bit(uint8_t data, uint8_t *buf)
+{
+    // Each color of 1 bit is represented by 3 bits of SPI, low_level:100 ,high_level:110
+    // So a color byte occupies 3 bytes of SPI.
+    *(buf + 2) |= data & BIT(0) ? BIT(2) | BIT(1) : BIT(2);
+    *(buf + 2) |= data & BIT(1) ? BIT(5) | BIT(4) : BIT(5);
+    *(buf + 2) |= data & BIT(2) ? BIT(7) : 0x00;
+    *(buf + 1) |= BIT(0);
+    *(buf + 1) |= data & BIT(3) ? BIT(3) | BIT(2) : BIT(3);
+    *(buf + 1) |= data & BIT(4) ? BIT(6) | BIT(5) : BIT(6);
+    *(buf + 0) |= data & BIT(5) ? BIT(1) | BIT(0) : BIT(1);
+    *(buf + 0) |= data & BIT(6) ? BIT(4) | BIT(3) : BIT(4);
+    *(buf + 0) |= data & BIT(7) ? BIT(7) | BIT(6) : BIT(7);
+}
+
+static void test_spi_lut_matches_bit_encoder(void)
+{
+    for (int data = 0; data < 256; data++) {
+        uint8_t expected[SPI_BYTES_PER_COLOR_BYTE] = {0};
+        uint8_t encoded[SPI_BYTES_PER_COLOR_BYTE];
+        __led_strip_spi_bit(data, expected);
+        led_strip_spi_encode_byte(data, encoded);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(expected, encoded, SPI_BYTES_PER_COLOR_BYTE, "color byte encoded differently");
+    }
+}
+
+static void test_spi_encode_matches_bit_encoder(void)
+{
+    uint8_t src[256];
+    uint8_t expected[sizeof(src) * SPI_BYTES_PER_COLOR_BYTE] = {0};
+    uint8_t encoded[sizeof(src) * SPI_BYTES_PER_COLOR_BYTE];
+    for (int i = 0; i < sizeof(src); i++) {
+        // every byte value, in an order where the neighbours differ
+        src[i] = i * 167;
+        __led_strip_spi_bit(src[i], &expected[i * SPI_BYTES_PER_COLOR_BYTE]);
+    }
+    led_strip_spi_encode(src, sizeof(src), encoded);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, encoded, sizeof(encoded));
+}
+
+// the SPI bytes captured for a frame are the GRB bytes of the pixels, encoded one by one
+static void test_spi_capture_frame(void)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = 8,
+        .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+        .led_model = LED_MODEL_WS2812,
+    };
+    led_strip_capture_config_t capture_config = {
+        .waveform = LED_STRIP_CAPTURE_WAVEFORM_SPI,
+    };
+    led_strip_handle_t strip = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_new_capture_device(&strip_config, &capture_config, &strip));
+    uint8_t expected[8 * 3 * SPI_BYTES_PER_COLOR_BYTE] = {0};
+    for (int i = 0; i < 8; i++) {
+        uint8_t red = i * 31, green = 255 - i, blue = i * 7;
+        TEST_ASSERT_EQUAL(ESP_OK, led_strip_set_pixel(strip, i, red, green, blue));
+        uint8_t *pixel = &expected[i * 3 * SPI_BYTES_PER_COLOR_BYTE];
+        __led_strip_spi_bit(green, pixel);
+        __led_strip_spi_bit(red, pixel + SPI_BYTES_PER_COLOR_BYTE);
+        __led_strip_spi_bit(blue, pixel + SPI_BYTES_PER_COLOR_BYTE * 2);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_refresh(strip));
+    const uint8_t *bytes = NULL;
+    size_t size = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_capture_get_spi_bytes(strip, &bytes, &size));
+    TEST_ASSERT_EQUAL(sizeof(expected), size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, bytes, size);
+    TEST_ASSERT_EQUAL(ESP_OK, led_strip_del(strip));
+}
+
+void test_spi_encoder_run(void)
+{
+    RUN_TEST(test_spi_lut_matches_bit_encoder);
+    RUN_TEST(test_spi_encode_matches_bit_encoder);
+    RUN_TEST(test_spi_capture_frame);
+}
@@ -14,6 +14,7 @@
  * - Task notifications for lightweight signaling
  * - Priority inheritance and dynamic task management
  * - Idle hooks for background processing
+ * - Latency benchmark of all the IPC primitives above
  *
  * NOTE: Only one demo should be active at a time to avoid resource conflicts.
  * Each demo is self-contained and demonstrates specific FreeRTOS concepts.
@@ -37,6 +38,7 @@
 #include "freertos_priority_inheritance.h"
 #include "freertos_dynamic_task.h"
 #include "freertos_idle_hook.h"
+#include "freertos_ipc_benchmark.h"
 
 // Demo Selection Macros
 // Uncomment ONE of the following lines to select the demo to run:
@@ -53,6 +55,7 @@
 // #define RUN_FREERTOS_PRIORITY_INHERITANCE_DEMO // Priority inheritance
 // #define RUN_FREERTOS_DYNAMIC_TASK_DEMO   // Dynamic task creation/deletion
 // #define RUN_FREERTOS_IDLE_HOOK_DEMO      // Background processing
+// #define RUN_FREERTOS_IPC_BENCHMARK_DEMO  // IPC primitive latency benchmark
 
 // Main application entry point
 // NOTE: This function is called by the ESP-IDF framework after system initialization
@@ -86,6 +89,8 @@ void app_main(void)
     freertos_dynamic_task_demo();
 #elif defined(RUN_FREERTOS_IDLE_HOOK_DEMO)
     freertos_idle_hook_demo();
+#elif defined(RUN_FREERTOS_IPC_BENCHMARK_DEMO)
+    freertos_ipc_benchmark_demo();
 #else
     // Compile-time error if no demo is selected
     #error "Please select a FreeRTOS demo to run by uncommenting one of the demo macros above."
@@ -0,0 +1,136 @@
+/*
+ * Zero-copy Byte Ring
+ * -------------------
+ * See byte_ring.h. The indexes run freely and are masked on access, so head - tail is always the
+ * number of bytes in the ring, even after they wrap around 2^32.
+ */
+#include "byte_ring.h"
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_check.h"
+
+static const char *TAG_BYTE_RING = "byte_ring";
+
+esp_err_t byte_ring_create(size_t size, size_t trigger_level, byte_ring_t **ret_ring) {
+    ESP_RETURN_ON_FALSE(size && size <= (1UL << 30) && ret_ring, ESP_ERR_INVALID_ARG, TAG_BYTE_RING, "invalid argument");
+    uint32_t ring_size = 1;
+    while (ring_size < size) {
+        ring_size <<= 1;
+    }
+    byte_ring_t *ring = calloc(1, sizeof(byte_ring_t));
+    ESP_RETURN_ON_FALSE(ring, ESP_ERR_NO_MEM, TAG_BYTE_RING, "no mem for ring");
+    ring->buf = malloc(ring_size);
+    if (!ring->buf) {
+        free(ring);
+        return ESP_ERR_NO_MEM;
+    }
+    ring->size = ring_size;
+    ring->mask = ring_size - 1;
+    // same clamping as xStreamBufferCreate
+    ring->trigger_level = trigger_level == 0 ? 1 : trigger_level > ring_size ? ring_size : trigger_level;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->rx_waiting, NULL);
+    atomic_init(&ring->tx_waiting, NULL);
+    *ret_ring = ring;
+    return ESP_OK;
+}
+
+void byte_ring_delete(byte_ring_t *ring) {
+    if (!ring) {
+        return;
+    }
+    free(ring->buf);
+    free(ring);
+}
+
+// Bytes the producer may write, or the consumer may read
+static inline uint32_t byte_ring_level(byte_ring_t *ring, bool producer) {
+    uint32_t used = atomic_load_explicit(&ring->head, memory_order_acquire) - atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return producer ? ring->size - used : used;
+}
+
+// Wake the task waiting on the other side, if any
+static inline void byte_ring_wake(TaskHandle_t _Atomic *waiting) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(waiting, memory_order_relaxed)) {
+        TaskHandle_t task = atomic_exchange_explicit(waiting, NULL, memory_order_relaxed);
+        if (task) {
+            xTaskNotifyGive(task);
+        }
+    }
+}
+
+// Block until `want` bytes are writable (producer) or readable (consumer), returns the level found
+static uint32_t byte_ring_wait(byte_ring_t *ring, bool producer, uint32_t want, TickType_t timeout) {
+    TaskHandle_t _Atomic *waiting = producer ? &ring->tx_waiting : &ring->rx_waiting;
+    TimeOut_t time_out;
+    // FreeRTOS API: vTaskSetTimeOutState / xTaskCheckForTimeOut - keep the total wait within `timeout` across wakeups
+    vTaskSetTimeOutState(&time_out);
+    while (1) {
+        uint32_t level = byte_ring_level(ring, producer);
+        if (level >= want || xTaskCheckForTimeOut(&time_out, &timeout) == pdTRUE) {
+            return level;
+        }
+        atomic_store_explicit(waiting, xTaskGetCurrentTaskHandle(), memory_order_relaxed);
+        // Pairs with the fence in byte_ring_wake: either the other side sees us waiting, or we see its update here
+        atomic_thread_fence(memory_order_seq_cst);
+        if (byte_ring_level(ring, producer) < want) {
+            if (producer) {
+                // no more bytes come until there's room, so a consumer held back by the trigger level gets what's there
+                byte_ring_wake(&ring->rx_waiting);
+            }
+            // a notification left over from an earlier wake only causes one more look
+            ulTaskNotifyTake(pdTRUE, timeout);
+        }
+        atomic_store_explicit(waiting, NULL, memory_order_relaxed);
+    }
+}
+
+// Point `spans` at `len` bytes from index `pos`, split where they wrap around the end of the ring
+static inline void byte_ring_spans(byte_ring_t *ring, uint32_t pos, uint32_t len, byte_ring_span_t spans[2]) {
+    uint32_t offset = pos & ring->mask;
+    uint32_t first = ring->size - offset;
+    if (first > len) {
+        first = len;
+    }
+    spans[0] = (byte_ring_span_t) { ring->buf + offset, first };
+    spans[1] = (byte_ring_span_t) { ring->buf, len - first };
+}
+
+size_t byte_ring_reserve(byte_ring_t *ring, size_t len, byte_ring_span_t spans[2], TickType_t timeout) {
+    if (len > ring->size) {
+        len = ring->size;
+    }
+    uint32_t space = byte_ring_wait(ring, true, len, timeout);
+    if (len > space) {
+        len = space;
+    }
+    byte_ring_spans(ring, atomic_load_explicit(&ring->head, memory_order_relaxed), len, spans);
+    return len;
+}
+
+void byte_ring_commit(byte_ring_t *ring, size_t len) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed) + len;
+    // release: the bytes written into the spans are visible before the new head
+    atomic_store_explicit(&ring->head, head, memory_order_release);
+    // like a stream buffer, the consumer is only woken once the trigger level is reached
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= ring->trigger_level) {
+        byte_ring_wake(&ring->rx_waiting);
+    }
+}
+
+size_t byte_ring_peek(byte_ring_t *ring, byte_ring_span_t spans[2], TickType_t timeout) {
+    // any byte will do, the trigger level only holds back the wake in byte_ring_commit. Waiting here for
+    // trigger_level bytes would deadlock a producer that needs the room those bytes take up
+    uint32_t count = byte_ring_wait(ring, false, 1, timeout);
+    byte_ring_spans(ring, atomic_load_explicit(&ring->tail, memory_order_relaxed), count, spans);
+    return count;
+}
+
+void byte_ring_consume(byte_ring_t *ring, size_t len) {
+    // release: the consumer is done reading the bytes before the producer may overwrite them
+    atomic_fetch_add_explicit(&ring->tail, len, memory_order_release);
+    byte_ring_wake(&ring->tx_waiting);
+}
@@ -0,0 +1,68 @@
+#ifndef BYTE_RING_H
+#define BYTE_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+/*
+ * Zero-copy byte ring
+ * -------------------
+ * A stream of bytes between one producer task and one consumer task, like a stream buffer, but both
+ * sides work directly in the ring memory instead of copying through xStreamBufferSend/Receive:
+ *
+ *   producer: byte_ring_reserve() -> write into the spans -> byte_ring_commit()
+ *   consumer: byte_ring_peek()    -> read from the spans  -> byte_ring_consume()
+ *
+ * A region that wraps around the end of the ring comes back as two spans, the second one empty
+ * when it doesn't wrap.
+ *
+ * Blocking follows the stream buffer: reserve waits for room, and peek returns at once if any bytes
+ * are there. Only an empty ring makes peek wait, and the producer wakes it once trigger_level bytes
+ * are committed, or earlier when it has to wait for room itself. On timeout both return what they
+ * have (maybe nothing).
+ *
+ * NOTE: Only ONE producer and ONE consumer task, and a waiting task's notification value (index 0)
+ * is taken over while it blocks. Not for ISRs.
+ */
+typedef struct {
+    uint8_t *ptr;
+    size_t len;
+} byte_ring_span_t;
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t size;                     // a power of two
+    uint32_t mask;                     // size - 1
+    uint32_t trigger_level;            // committed bytes that wake a consumer waiting on an empty ring
+    _Atomic uint32_t head;             // end of the committed bytes, written by the producer only
+    _Atomic uint32_t tail;             // end of the consumed bytes, written by the consumer only
+    TaskHandle_t _Atomic rx_waiting;   // consumer blocked in peek, or NULL
+    TaskHandle_t _Atomic tx_waiting;   // producer blocked in reserve, or NULL
+} byte_ring_t;
+
+// Create a ring of `size` bytes (rounded up to a power of two), trigger_level is at least 1 and at most the size
+esp_err_t byte_ring_create(size_t size, size_t trigger_level, byte_ring_t **ret_ring);
+
+// Delete the ring, neither side may use it anymore
+void byte_ring_delete(byte_ring_t *ring);
+
+// Producer: wait up to `timeout` for `len` free bytes, and point `spans` at them.
+// Returns the bytes reserved, less than `len` on timeout
+size_t byte_ring_reserve(byte_ring_t *ring, size_t len, byte_ring_span_t spans[2], TickType_t timeout);
+
+// Producer: hand the first `len` reserved bytes to the consumer
+void byte_ring_commit(byte_ring_t *ring, size_t len);
+
+// Consumer: point `spans` at all the bytes there. If the ring is empty, wait up to `timeout` to be
+// woken at the trigger level. Returns the bytes available, fewer than trigger_level (maybe 0) on timeout
+size_t byte_ring_peek(byte_ring_t *ring, byte_ring_span_t spans[2], TickType_t timeout);
+
+// Consumer: give the first `len` peeked bytes back to the producer
+void byte_ring_consume(byte_ring_t *ring, size_t len);
+
+#endif // BYTE_RING_H
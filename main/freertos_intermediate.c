@@ -10,6 +10,8 @@
  * - GPIO input (button) and output (LED) configuration
  * - Interrupt Service Routine (ISR) implementation
  * - ISR to task communication using queues
+ * - Yielding from an ISR to the task it woke, and measuring the ISR-to-task latency
+ * - Debouncing the button, so one physical press wakes the task once (gpio_input.h)
  * - Print/log statements
  *
  * NOTE: This demonstrates a key FreeRTOS concept - safe communication between
@@ -19,50 +21,122 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "sdkconfig.h"
+#include "isr_event_channel.h"
+#include "gpio_input.h"
 
 // Use the GPIO defined in menuconfig or sdkconfig for LED
 #define INTERMEDIATE_BLINK_GPIO CONFIG_BLINK_GPIO
 // Use GPIO0 (BOOT button) for button input
 #define INTERMEDIATE_BUTTON_GPIO 0
+// 1: the debounced input service reports one release per physical press, with how long it was held
+// 0: the raw falling edge ISR below, every bounce of the contact is an event
+#define INTERMEDIATE_USE_GPIO_INPUT 0
+// The contact must be quiet this long before its level counts
+#define INTERMEDIATE_DEBOUNCE_US 20000
+// How button events reach button_task:
+// ISR_EVENT_CHANNEL_QUEUE  - FreeRTOS queue (xQueueSendFromISR)
+// ISR_EVENT_CHANNEL_NOTIFY - task notification, repeated presses are merged until the task runs
+// ISR_EVENT_CHANNEL_RING   - lock-free SPSC ring, no critical section or queue lock in the ISR
+#define INTERMEDIATE_EVENT_BACKEND ISR_EVENT_CHANNEL_QUEUE
 
 static const char *TAG_INTERMEDIATE = "freertos_intermediate";
-static QueueHandle_t button_evt_queue = NULL;
+#if INTERMEDIATE_USE_GPIO_INPUT
+static gpio_input_handle_t button_input = NULL;
+#else
+static isr_event_channel_handle_t button_evt_channel = NULL;
+#endif
 
 typedef enum {
     BUTTON_PRESSED,
     BUTTON_RELEASED
 } button_event_t;
 
+#if INTERMEDIATE_USE_GPIO_INPUT
+// Task: Waits for debounced button events and toggles the LED
+// NOTE: The input service queues one event per settled change, however much the contact bounces
+static void button_input_task(void *pvParameter) {
+    gpio_input_event_t evt;
+    uint32_t presses = 0;
+
+    gpio_input_config_t input_config = {
+        .debounce_us = INTERMEDIATE_DEBOUNCE_US,
+        .queue_length = 10,
+    };
+    ESP_ERROR_CHECK(gpio_input_create(&input_config, &button_input));
+    // Only the release is reported, so the task wakes once per press and knows how long it was held
+    gpio_input_pin_config_t pin_config = {
+        .gpio = INTERMEDIATE_BUTTON_GPIO,
+        .active_low = true,
+        .notify = GPIO_INPUT_NOTIFY_RELEASE,
+    };
+    ESP_ERROR_CHECK(gpio_input_add_pin(button_input, &pin_config));
+
+    while (1) {
+        if (gpio_input_receive(button_input, &evt, portMAX_DELAY)) {
+            ESP_LOGI(TAG_INTERMEDIATE, "Button pressed for %lu ms (%lu edges)! Toggling LED.",
+                     (unsigned long)evt.duration_ms, (unsigned long)evt.edges);
+            int level = gpio_get_level(INTERMEDIATE_BLINK_GPIO);
+            gpio_set_level(INTERMEDIATE_BLINK_GPIO, !level); // Toggle LED
+            // Print the bounce counters every 10 presses
+            if (++presses % 10 == 0) {
+                gpio_input_pin_stats_t stats;
+                gpio_input_get_pin_stats(button_input, INTERMEDIATE_BUTTON_GPIO, &stats);
+                ESP_LOGI(TAG_INTERMEDIATE, "%lu presses from %lu edges, %lu glitches, %lu dropped",
+                         (unsigned long)stats.presses, (unsigned long)stats.edges,
+                         (unsigned long)stats.glitches, (unsigned long)stats.dropped);
+            }
+        }
+    }
+}
+
+#else
 // ISR: Called when button is pressed (falling edge)
 // NOTE: ISR functions must be fast and cannot use most FreeRTOS APIs
 // Only xQueueSendFromISR, xSemaphoreGiveFromISR, and xTaskNotifyFromISR are safe
 static void IRAM_ATTR button_isr_handler(void* arg) {
-    button_event_t evt = BUTTON_PRESSED;
-    // FreeRTOS API: xQueueSendFromISR - Sends data to queue from ISR context
-    // Parameters: queue handle, data pointer, higher priority task woken flag
-    // NOTE: This is the ONLY safe way to communicate from ISR to task
-    xQueueSendFromISR(button_evt_queue, &evt, NULL);
+    // The channel stamps the event, sends it (e.g. with xQueueSendFromISR) and passes its
+    // pxHigherPriorityTaskWoken flag to portYIELD_FROM_ISR, so button_task runs as
+    // soon as the ISR returns instead of at the next tick (up to 10ms at 100Hz)
+    isr_event_channel_send_from_isr(button_evt_channel, BUTTON_PRESSED, 0);
 }
 
 // Task: Waits for button press events and toggles the LED
 // NOTE: This task demonstrates blocking on a queue to wait for events
 static void button_task(void *pvParameter) {
-    button_event_t evt;
+    isr_event_t evt;
+    uint32_t presses = 0;
+
+    // The channel creates its queue (or ring) here, as the notify and ring backends wake this task
+    // NOTE: Length of 10 means it can hold 10 button events before dropping them
+    isr_event_channel_config_t channel_config = {
+        .mode = INTERMEDIATE_EVENT_BACKEND,
+        .queue_length = 10,
+        .handler = xTaskGetCurrentTaskHandle(),
+    };
+    ESP_ERROR_CHECK(isr_event_channel_create(&channel_config, &button_evt_channel));
+
+    // Install ISR service and add handler for button GPIO, once the channel exists
+    gpio_install_isr_service(0);
+    gpio_isr_handler_add(INTERMEDIATE_BUTTON_GPIO, button_isr_handler, NULL);
+
     while (1) {
-        // FreeRTOS API: xQueueReceive - Receives data from queue, blocks if empty
-        // Parameters: queue handle, data buffer, timeout (portMAX_DELAY = wait forever)
+        // Blocks inside the channel (e.g. on xQueueReceive) until the ISR sends an event
         // NOTE: This task will block here until the ISR sends data to the queue
-        if (xQueueReceive(button_evt_queue, &evt, portMAX_DELAY)) {
+        if (isr_event_channel_receive(button_evt_channel, &evt, portMAX_DELAY)) {
             ESP_LOGI(TAG_INTERMEDIATE, "Button pressed! Toggling LED.");
             int level = gpio_get_level(INTERMEDIATE_BLINK_GPIO);
             gpio_set_level(INTERMEDIATE_BLINK_GPIO, !level); // Toggle LED
+            // Print the ISR-to-task latency histogram every 10 presses
+            if (++presses % 10 == 0) {
+                isr_event_channel_print_stats(button_evt_channel);
+            }
         }
     }
 }
+#endif
 
 // Entry point for the intermediate FreeRTOS demo
 void freertos_intermediate_demo(void) {
@@ -70,22 +144,18 @@ void freertos_intermediate_demo(void) {
     // Configure LED GPIO as output
     gpio_reset_pin(INTERMEDIATE_BLINK_GPIO);
     gpio_set_direction(INTERMEDIATE_BLINK_GPIO, GPIO_MODE_OUTPUT);
+#if INTERMEDIATE_USE_GPIO_INPUT
+    // The input service configures the button pin itself
+    xTaskCreate(button_input_task, "button_task", 2048, NULL, 10, NULL);
+#else
     // Configure button GPIO as input
     gpio_reset_pin(INTERMEDIATE_BUTTON_GPIO);
     gpio_set_direction(INTERMEDIATE_BUTTON_GPIO, GPIO_MODE_INPUT);
     gpio_set_intr_type(INTERMEDIATE_BUTTON_GPIO, GPIO_INTR_NEGEDGE); // Interrupt on falling edge
     
-    // FreeRTOS API: xQueueCreate - Creates a new queue
-    // Parameters: queue length, item size in bytes
-    // NOTE: Queue length of 10 means it can hold 10 button events before blocking
-    button_evt_queue = xQueueCreate(10, sizeof(button_event_t));
-    
     // FreeRTOS API: xTaskCreate - Creates the button handling task
     // Parameters: task function, task name, stack size, parameters, priority, task handle
     // NOTE: Higher priority (10) ensures button events are handled promptly
     xTaskCreate(button_task, "button_task", 2048, NULL, 10, NULL);
-    
-    // Install ISR service and add handler for button GPIO
-    gpio_install_isr_service(0);
-    gpio_isr_handler_add(INTERMEDIATE_BUTTON_GPIO, button_isr_handler, NULL);
+#endif
 } 
\ No newline at end of file
@@ -9,6 +9,10 @@
  *
  * NOTE: Stream buffers treat data as a continuous stream of bytes, unlike message buffers
  * which preserve message boundaries. Ideal for continuous data flow applications.
+ *
+ * xStreamBufferSend copies the data into the buffer and xStreamBufferReceive copies it out again.
+ * The zero-copy byte ring (byte_ring.h) lets the sender write and the receiver read in the ring
+ * memory itself, with the same trigger level and blocking. A short benchmark compares the two.
  */
 #include "freertos_stream_buffer.h"
 #include <stdio.h>
@@ -16,8 +20,21 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/stream_buffer.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
 #include "esp_log.h"
+#include "byte_ring.h"
+
+// 1: the demo tasks use the zero-copy byte ring, 0: the stream buffer
+#define STREAM_DEMO_USE_BYTE_RING 0
+// Benchmark: bytes streamed, buffer size, trigger level and bytes written at a time (not a power of two, so writes wrap)
+#define STREAM_BENCH_BYTES   (256 * 1024)
+#define STREAM_BENCH_SIZE    1024
+#define STREAM_BENCH_TRIGGER 64
+#define STREAM_BENCH_CHUNK   48
 
+static const char *TAG_STREAM = "freertos_stream_buffer";
+#if !STREAM_DEMO_USE_BYTE_RING
 static StreamBufferHandle_t stream_buf;
 
 // Task that sends data to the stream buffer
@@ -52,7 +69,151 @@ static void stream_receiver_task(void *pvParameter) {
     }
 }
 
+#else
+static byte_ring_t *stream_ring;
+
+// Same as stream_sender_task, but the message is written straight into the ring
+static void ring_sender_task(void *pvParameter) {
+    const char *msgs[] = {"Hello", "FreeRTOS", "ByteRing!"};
+    int idx = 0;
+    while (1) {
+        size_t len = strlen(msgs[idx]);
+        byte_ring_span_t spans[2];
+        // Blocks like xStreamBufferSend until there is room for the whole message
+        size_t reserved = byte_ring_reserve(stream_ring, len, spans, portMAX_DELAY);
+        // NOTE: The reserved bytes may wrap around the end of the ring, the second span holds the rest
+        memcpy(spans[0].ptr, msgs[idx], spans[0].len);
+        memcpy(spans[1].ptr, msgs[idx] + spans[0].len, spans[1].len);
+        byte_ring_commit(stream_ring, reserved);
+        printf("ring_sender: sent '%s'\n", msgs[idx]);
+        idx = (idx + 1) % 3;
+        vTaskDelay(1000 / portTICK_PERIOD_MS);
+    }
+}
+
+// Same as stream_receiver_task, but the bytes are printed from the ring without copying them out
+static void ring_receiver_task(void *pvParameter) {
+    while (1) {
+        byte_ring_span_t spans[2];
+        // Like xStreamBufferReceive: returns at once with the bytes there, an empty ring waits for the trigger level
+        size_t rcvd = byte_ring_peek(stream_ring, spans, portMAX_DELAY);
+        printf("ring_receiver: got '%.*s%.*s'\n", (int)spans[0].len, (char *)spans[0].ptr,
+               (int)spans[1].len, (char *)spans[1].ptr);
+        // The sender may only reuse the bytes once they are consumed
+        byte_ring_consume(stream_ring, rcvd);
+    }
+}
+#endif
+
+// Benchmark state shared by the producer task and the consumer (the demo task)
+typedef struct {
+    StreamBufferHandle_t buf; // NULL when the ring is used
+    byte_ring_t *ring;
+    SemaphoreHandle_t done;   // given by the producer when it has written everything
+} stream_bench_t;
+
+static stream_bench_t s_bench;
+
+// The byte the benchmark streams at position `pos`
+static inline uint8_t stream_bench_byte(uint32_t pos) {
+    return (uint8_t)(pos * 7);
+}
+
+// Benchmark producer: generate STREAM_BENCH_BYTES, into a local chunk and xStreamBufferSend, or straight into the ring
+static void stream_bench_producer_task(void *pvParameter) {
+    uint8_t chunk[STREAM_BENCH_CHUNK];
+    uint32_t sent = 0;
+    while (sent < STREAM_BENCH_BYTES) {
+        size_t len = STREAM_BENCH_BYTES - sent < STREAM_BENCH_CHUNK ? STREAM_BENCH_BYTES - sent : STREAM_BENCH_CHUNK;
+        if (s_bench.ring) {
+            byte_ring_span_t spans[2];
+            len = byte_ring_reserve(s_bench.ring, len, spans, portMAX_DELAY);
+            uint32_t pos = sent;
+            for (int s = 0; s < 2; s++) {
+                for (size_t i = 0; i < spans[s].len; i++) {
+                    spans[s].ptr[i] = stream_bench_byte(pos++);
+                }
+            }
+            byte_ring_commit(s_bench.ring, len);
+        } else {
+            for (size_t i = 0; i < len; i++) {
+                chunk[i] = stream_bench_byte(sent + i);
+            }
+            len = xStreamBufferSend(s_bench.buf, chunk, len, portMAX_DELAY);
+        }
+        sent += len;
+    }
+    xSemaphoreGive(s_bench.done);
+    vTaskDelete(NULL);
+}
+
+// Benchmark consumer: read and check every byte, through a local buffer or straight from the ring
+static void stream_bench_run(bool use_ring) {
+    s_bench = (stream_bench_t) { 0 };
+    s_bench.done = xSemaphoreCreateBinary();
+    if (use_ring) {
+        byte_ring_create(STREAM_BENCH_SIZE, STREAM_BENCH_TRIGGER, &s_bench.ring);
+    } else {
+        s_bench.buf = xStreamBufferCreate(STREAM_BENCH_SIZE, STREAM_BENCH_TRIGGER);
+    }
+    if (!s_bench.done || !(s_bench.ring || s_bench.buf)) {
+        ESP_LOGE(TAG_STREAM, "No memory for the benchmark");
+        goto cleanup;
+    }
+    uint8_t buf[STREAM_BENCH_SIZE / 2];
+    uint32_t received = 0;
+    uint32_t errors = 0;
+    uint32_t reads = 0;
+    int64_t start_us = esp_timer_get_time();
+    xTaskCreate(stream_bench_producer_task, "stream_bench", 2048, NULL, uxTaskPriorityGet(NULL), NULL);
+    while (received < STREAM_BENCH_BYTES) {
+        // NOTE: The short timeout picks up the tail of the stream, which may stay below the trigger level
+        if (use_ring) {
+            byte_ring_span_t spans[2];
+            size_t len = byte_ring_peek(s_bench.ring, spans, pdMS_TO_TICKS(10));
+            for (int s = 0; s < 2; s++) {
+                for (size_t i = 0; i < spans[s].len; i++) {
+                    errors += spans[s].ptr[i] != stream_bench_byte(received++);
+                }
+            }
+            byte_ring_consume(s_bench.ring, len);
+        } else {
+            size_t len = xStreamBufferReceive(s_bench.buf, buf, sizeof(buf), pdMS_TO_TICKS(10));
+            for (size_t i = 0; i < len; i++) {
+                errors += buf[i] != stream_bench_byte(received++);
+            }
+        }
+        reads++;
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    // the ring or buffer may only go once the producer is out of it
+    xSemaphoreTake(s_bench.done, portMAX_DELAY);
+    printf("%-14s %8lu bytes in %7lld us, %8.0f KB/s, %6lu reads, %lu bad bytes\n",
+           use_ring ? "byte_ring" : "stream_buffer", (unsigned long)received, (long long)elapsed_us,
+           received / 1024.0 * 1000000 / (elapsed_us ? elapsed_us : 1), (unsigned long)reads, (unsigned long)errors);
+cleanup:
+    byte_ring_delete(s_bench.ring);
+    if (s_bench.buf) {
+        vStreamBufferDelete(s_bench.buf);
+    }
+    if (s_bench.done) {
+        vSemaphoreDelete(s_bench.done);
+    }
+}
+
 void freertos_stream_buffer_demo(void) {
+    // Throughput of the copying stream buffer against the zero-copy ring, same size and trigger level
+    printf("Streaming %d bytes in %d byte writes, %d byte buffer, trigger level %d\n",
+           STREAM_BENCH_BYTES, STREAM_BENCH_CHUNK, STREAM_BENCH_SIZE, STREAM_BENCH_TRIGGER);
+    stream_bench_run(false);
+    stream_bench_run(true);
+
+#if STREAM_DEMO_USE_BYTE_RING
+    // Same size and trigger level as the stream buffer below
+    ESP_ERROR_CHECK(byte_ring_create(64, 4, &stream_ring));
+    xTaskCreate(ring_sender_task, "stream_sender", 2048, NULL, 4, NULL);
+    xTaskCreate(ring_receiver_task, "stream_receiver", 2048, NULL, 5, NULL);
+#else
     // FreeRTOS API: xStreamBufferCreate - Creates a stream buffer
     // Parameters: buffer size in bytes, trigger level (bytes that trigger receive)
     // NOTE: Trigger level determines when a waiting receiver is woken up
@@ -63,4 +224,5 @@ void freertos_stream_buffer_demo(void) {
     // NOTE: Stream buffers are ideal for continuous data flow applications
     xTaskCreate(stream_sender_task, "stream_sender", 2048, NULL, 4, NULL);
     xTaskCreate(stream_receiver_task, "stream_receiver", 2048, NULL, 5, NULL);
+#endif
 } 
\ No newline at end of file
@@ -0,0 +1,215 @@
+/*
+ * Debounced GPIO Input Service
+ * ----------------------------
+ * Turns the raw edges of buttons and switches into one press or release event per physical change.
+ *
+ * WHAT: The GPIO ISR of a pin only stamps the edge and, on the first edge of a burst, starts a one-shot
+ *       esp_timer. The timer callback waits until the pin has been quiet for debounce_us, reads the settled
+ *       level, and queues a single press or release event with the time since the previous change.
+ * WHY: A bouncing contact fires dozens of edges per press. Queueing every edge fills the queue and wakes
+ *      the handler task for each of them, while here the ISR makes no FreeRTOS call at all and the
+ *      handler wakes once per change.
+ * WHEN: Use for buttons, reed switches and other mechanical contacts, on as many pins as needed.
+ *
+ * NOTE: A tap shorter than debounce_us settles in the level it started from and is counted as a glitch,
+ * not reported.
+ */
+#include "gpio_input.h"
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG_GPIO_INPUT = "gpio_input";
+
+typedef struct gpio_input_t gpio_input_t;
+
+typedef struct {
+    gpio_input_t *input;
+    gpio_num_t gpio;
+    bool active_low;
+    uint32_t notify;
+    esp_timer_handle_t timer;
+    bool debouncing;       // ISR: the settle timer is armed
+    int64_t first_edge_us; // ISR: first edge of the current burst
+    int64_t last_edge_us;  // ISR: latest edge of the current burst
+    uint32_t burst_edges;  // ISR: edges of the current burst
+    bool pressed;          // timer: settled state
+    int64_t changed_us;    // timer: time of the last settled change
+    gpio_input_pin_stats_t stats;
+} gpio_input_pin_t;
+
+struct gpio_input_t {
+    uint32_t debounce_us;
+    QueueHandle_t queue;
+    portMUX_TYPE lock; // shared by the ISRs and the timer callbacks, which may run on different cores
+    uint32_t num_pins;
+    gpio_input_pin_t pins[GPIO_INPUT_MAX_PINS];
+};
+
+esp_err_t gpio_input_create(const gpio_input_config_t *config, gpio_input_handle_t *ret_input) {
+    ESP_RETURN_ON_FALSE(config && config->debounce_us && config->queue_length && ret_input, ESP_ERR_INVALID_ARG,
+                        TAG_GPIO_INPUT, "invalid argument");
+    // NOTE: The ISRs touch the pins, so they must not end up in PSRAM
+    gpio_input_t *input = heap_caps_calloc(1, sizeof(gpio_input_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_RETURN_ON_FALSE(input, ESP_ERR_NO_MEM, TAG_GPIO_INPUT, "no mem for input");
+    input->debounce_us = config->debounce_us;
+    input->lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    input->queue = xQueueCreate(config->queue_length, sizeof(gpio_input_event_t));
+    if (!input->queue) {
+        free(input);
+        return ESP_ERR_NO_MEM;
+    }
+    *ret_input = input;
+    return ESP_OK;
+}
+
+// Every edge: stamp it, and arm the settle timer on the first edge of a burst
+static void IRAM_ATTR gpio_input_isr_handler(void *arg) {
+    gpio_input_pin_t *pin = (gpio_input_pin_t *)arg;
+    int64_t now = esp_timer_get_time();
+    bool arm = false;
+    portENTER_CRITICAL_ISR(&pin->input->lock);
+    pin->stats.edges++;
+    pin->burst_edges++;
+    pin->last_edge_us = now;
+    if (!pin->debouncing) {
+        pin->debouncing = true;
+        pin->first_edge_us = now;
+        arm = true;
+    }
+    portEXIT_CRITICAL_ISR(&pin->input->lock);
+    // the bounces that follow only update the stamp above, the timer callback looks at them when it fires
+    // NOTE: esp_timer_start_once is in IRAM and may be called from an ISR
+    if (arm) {
+        esp_timer_start_once(pin->timer, pin->input->debounce_us);
+    }
+}
+
+// Settle timer: wait for debounce_us of quiet, then report the settled level once
+static void gpio_input_settle_cb(void *arg) {
+    gpio_input_pin_t *pin = (gpio_input_pin_t *)arg;
+    gpio_input_t *input = pin->input;
+    int64_t now = esp_timer_get_time();
+    int64_t first_edge_us = 0;
+    uint32_t edges = 0;
+    int64_t quiet_us;
+
+    portENTER_CRITICAL(&input->lock);
+    quiet_us = now - pin->last_edge_us;
+    if (quiet_us >= input->debounce_us) {
+        // an edge after this point arms the timer again, and that run reads the level again
+        pin->debouncing = false;
+        first_edge_us = pin->first_edge_us;
+        edges = pin->burst_edges;
+        pin->burst_edges = 0;
+    }
+    portEXIT_CRITICAL(&input->lock);
+    if (quiet_us < input->debounce_us) {
+        // still bouncing, come back when the latest edge is debounce_us old
+        esp_timer_start_once(pin->timer, input->debounce_us - quiet_us);
+        return;
+    }
+
+    bool pressed = gpio_get_level(pin->gpio) != pin->active_low;
+    if (pressed == pin->pressed) {
+        portENTER_CRITICAL(&input->lock);
+        pin->stats.glitches++;
+        portEXIT_CRITICAL(&input->lock);
+        return;
+    }
+    gpio_input_event_t evt = {
+        .gpio = pin->gpio,
+        .type = pressed ? GPIO_INPUT_PRESS : GPIO_INPUT_RELEASE,
+        .duration_ms = pin->changed_us ? (uint32_t)((first_edge_us - pin->changed_us) / 1000) : 0,
+        .edges = edges,
+        .time_us = first_edge_us,
+    };
+    pin->pressed = pressed;
+    pin->changed_us = first_edge_us;
+    // FreeRTOS API: xQueueSend - never block the esp_timer task, a full queue drops the event
+    bool dropped = (pin->notify & (1U << evt.type)) && xQueueSend(input->queue, &evt, 0) != pdTRUE;
+    portENTER_CRITICAL(&input->lock);
+    if (pressed) {
+        pin->stats.presses++;
+    } else {
+        pin->stats.releases++;
+    }
+    if (dropped) {
+        pin->stats.dropped++;
+    }
+    portEXIT_CRITICAL(&input->lock);
+}
+
+esp_err_t gpio_input_add_pin(gpio_input_handle_t input, const gpio_input_pin_config_t *pin_config) {
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(input && pin_config, ESP_ERR_INVALID_ARG, TAG_GPIO_INPUT, "invalid argument");
+    ESP_RETURN_ON_FALSE(input->num_pins < GPIO_INPUT_MAX_PINS, ESP_ERR_NO_MEM, TAG_GPIO_INPUT, "too many pins");
+    gpio_input_pin_t *pin = &input->pins[input->num_pins];
+    *pin = (gpio_input_pin_t) {
+        .input = input,
+        .gpio = pin_config->gpio,
+        .active_low = pin_config->active_low,
+        .notify = pin_config->notify,
+    };
+    esp_timer_create_args_t timer_args = {
+        .callback = gpio_input_settle_cb,
+        .arg = pin,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "gpio_input",
+    };
+    ESP_RETURN_ON_ERROR(esp_timer_create(&timer_args, &pin->timer), TAG_GPIO_INPUT, "create settle timer failed");
+
+    gpio_config_t io_config = {
+        .pin_bit_mask = 1ULL << pin_config->gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = pin_config->active_low ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+        .pull_down_en = pin_config->active_low ? GPIO_PULLDOWN_DISABLE : GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_ANYEDGE, // both edges, the timer sorts out which one it settles on
+    };
+    ESP_GOTO_ON_ERROR(gpio_config(&io_config), err, TAG_GPIO_INPUT, "configure gpio %d failed", pin_config->gpio);
+    pin->pressed = gpio_get_level(pin->gpio) != pin->active_low;
+    // another module may have installed the service already
+    ret = gpio_install_isr_service(0);
+    ESP_GOTO_ON_FALSE(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE, ret, err, TAG_GPIO_INPUT, "install isr service failed");
+    ESP_GOTO_ON_ERROR(gpio_isr_handler_add(pin->gpio, gpio_input_isr_handler, pin), err, TAG_GPIO_INPUT, "add isr handler failed");
+    input->num_pins++;
+    return ESP_OK;
+err:
+    esp_timer_delete(pin->timer);
+    return ret;
+}
+
+bool gpio_input_receive(gpio_input_handle_t input, gpio_input_event_t *ret_event, TickType_t timeout) {
+    return xQueueReceive(input->queue, ret_event, timeout) == pdTRUE;
+}
+
+esp_err_t gpio_input_get_pin_stats(gpio_input_handle_t input, gpio_num_t gpio, gpio_input_pin_stats_t *ret_stats) {
+    ESP_RETURN_ON_FALSE(input && ret_stats, ESP_ERR_INVALID_ARG, TAG_GPIO_INPUT, "invalid argument");
+    for (uint32_t i = 0; i < input->num_pins; i++) {
+        if (input->pins[i].gpio == gpio) {
+            portENTER_CRITICAL(&input->lock);
+            *ret_stats = input->pins[i].stats;
+            portEXIT_CRITICAL(&input->lock);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+void gpio_input_delete(gpio_input_handle_t input) {
+    if (!input) {
+        return;
+    }
+    for (uint32_t i = 0; i < input->num_pins; i++) {
+        gpio_input_pin_t *pin = &input->pins[i];
+        gpio_isr_handler_remove(pin->gpio);
+        esp_timer_stop(pin->timer);
+        esp_timer_delete(pin->timer);
+    }
+    vQueueDelete(input->queue);
+    free(input);
+}
@@ -0,0 +1,67 @@
+#ifndef GPIO_INPUT_H
+#define GPIO_INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+// Number of pins one input service can watch
+#define GPIO_INPUT_MAX_PINS 8
+
+typedef enum {
+    GPIO_INPUT_PRESS,   // The pin settled in its active level
+    GPIO_INPUT_RELEASE, // The pin settled back in its idle level
+} gpio_input_event_type_t;
+
+// Bits of gpio_input_pin_config_t.notify, the events the pin reports to the receiving task
+#define GPIO_INPUT_NOTIFY_PRESS   (1U << GPIO_INPUT_PRESS)
+#define GPIO_INPUT_NOTIFY_RELEASE (1U << GPIO_INPUT_RELEASE)
+
+// One debounced change of a pin, however many edges it bounced through
+typedef struct {
+    gpio_num_t gpio;
+    gpio_input_event_type_t type;
+    uint32_t duration_ms; // Release: how long the pin was pressed. Press: how long it was released before
+    uint32_t edges;       // Raw edges (bounces included) merged into this event
+    int64_t time_us;      // esp_timer time of the first edge of the change
+} gpio_input_event_t;
+
+typedef struct {
+    uint32_t debounce_us;  // The pin must stay quiet this long before its level counts
+    uint32_t queue_length; // Events the receiving task can fall behind by, more are dropped
+} gpio_input_config_t;
+
+typedef struct {
+    gpio_num_t gpio;
+    bool active_low; // Pressed at level 0 (e.g. a button to ground) with the internal pull-up, else the pull-down
+    uint32_t notify; // GPIO_INPUT_NOTIFY_* bits
+} gpio_input_pin_config_t;
+
+typedef struct {
+    uint32_t presses;
+    uint32_t releases;
+    uint32_t edges;    // Raw edges seen by the ISR
+    uint32_t glitches; // Bursts that settled back in the level they started from
+    uint32_t dropped;  // Events lost because the queue was full
+} gpio_input_pin_stats_t;
+
+typedef struct gpio_input_t *gpio_input_handle_t;
+
+// Create an input service, returns ESP_ERR_INVALID_ARG or ESP_ERR_NO_MEM on failure
+esp_err_t gpio_input_create(const gpio_input_config_t *config, gpio_input_handle_t *ret_input);
+
+// Configure a pin as input and start watching it, installs the GPIO ISR service if needed
+esp_err_t gpio_input_add_pin(gpio_input_handle_t input, const gpio_input_pin_config_t *pin_config);
+
+// Wait for the next debounced event of any pin. Returns false on timeout
+bool gpio_input_receive(gpio_input_handle_t input, gpio_input_event_t *ret_event, TickType_t timeout);
+
+// Copy the counters of a pin, returns ESP_ERR_NOT_FOUND if the pin is not watched
+esp_err_t gpio_input_get_pin_stats(gpio_input_handle_t input, gpio_num_t gpio, gpio_input_pin_stats_t *ret_stats);
+
+// Stop watching all pins and delete the service
+void gpio_input_delete(gpio_input_handle_t input);
+
+#endif // GPIO_INPUT_H
@@ -0,0 +1,240 @@
+/*
+ * ISR Event Channel
+ * -----------------
+ * Carries events from an interrupt to a handler task with as little delay as possible.
+ *
+ * WHAT: The ISR stamps every event with esp_timer_get_time() and hands it over through a queue or a task
+ *       notification. The handler task works out the ISR-to-task latency of every event it receives and
+ *       keeps a histogram of it.
+ * WHY: A FromISR call that wakes a higher priority task only makes it ready. Unless the ISR yields, the
+ *      task runs at the next tick interrupt, up to 10ms later at 100Hz.
+ * WHEN: Use for button, sensor or peripheral interrupts that a task has to react to quickly.
+ *
+ * NOTE: The notify mode needs no queue storage and no item copy, but events of the same id that arrive
+ * before the handler takes them are merged into one (the latest stamp and data are kept).
+ * The ring mode keeps every event without a critical section, and only notifies the handler when it
+ * is waiting for the ring to fill. It needs a single producer (one ISR).
+ */
+#include "isr_event_channel.h"
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "spsc_ring.h"
+
+// Events the handler takes out of the ring at once
+#define ISR_EVENT_CHANNEL_BATCH 8
+
+SPSC_RING_DEFINE_TYPED(isr_event_ring, isr_event_t)
+
+static const char *TAG_ISR_EVENT = "isr_event_channel";
+
+typedef struct isr_event_channel_t {
+    isr_event_channel_mode_t mode;
+    QueueHandle_t queue;
+    spsc_ring_t *ring;
+    isr_event_t batch[ISR_EVENT_CHANNEL_BATCH]; // ring mode: events taken out of the ring, handed out one by one
+    uint32_t batch_len;
+    uint32_t batch_pos;
+    TaskHandle_t handler;
+    portMUX_TYPE lock;             // shared by the ISR and the tasks, protects everything below
+    uint32_t pending;              // notify mode: ids sent but not taken yet
+    int64_t stamps[32];            // notify mode: ISR time of the latest event of every id
+    uint32_t data[32];             // notify mode: data of the latest event of every id
+    isr_event_channel_stats_t stats;
+    uint64_t latency_sum_us;
+} isr_event_channel_t;
+
+esp_err_t isr_event_channel_create(const isr_event_channel_config_t *config, isr_event_channel_handle_t *ret_channel) {
+    ESP_RETURN_ON_FALSE(config && ret_channel, ESP_ERR_INVALID_ARG, TAG_ISR_EVENT, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->mode == ISR_EVENT_CHANNEL_NOTIFY || config->queue_length, ESP_ERR_INVALID_ARG, TAG_ISR_EVENT, "queue and ring mode need a length");
+    ESP_RETURN_ON_FALSE(config->mode == ISR_EVENT_CHANNEL_QUEUE || config->handler, ESP_ERR_INVALID_ARG, TAG_ISR_EVENT, "notify and ring mode need a handler task");
+    // NOTE: The ISR touches the channel, so it must not end up in PSRAM
+    isr_event_channel_t *channel = heap_caps_calloc(1, sizeof(isr_event_channel_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_RETURN_ON_FALSE(channel, ESP_ERR_NO_MEM, TAG_ISR_EVENT, "no mem for channel");
+    channel->mode = config->mode;
+    channel->handler = config->handler;
+    channel->lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    channel->stats.min_us = UINT32_MAX;
+    if (config->mode == ISR_EVENT_CHANNEL_QUEUE) {
+        channel->queue = xQueueCreate(config->queue_length, sizeof(isr_event_t));
+        if (!channel->queue) {
+            free(channel);
+            return ESP_ERR_NO_MEM;
+        }
+    } else if (config->mode == ISR_EVENT_CHANNEL_RING) {
+        esp_err_t ret = isr_event_ring_create(config->queue_length, config->handler, &channel->ring);
+        if (ret != ESP_OK) {
+            free(channel);
+            return ret;
+        }
+    }
+    *ret_channel = channel;
+    return ESP_OK;
+}
+
+bool IRAM_ATTR isr_event_channel_send_from_isr(isr_event_channel_handle_t channel, uint32_t id, uint32_t data) {
+    BaseType_t woken = pdFALSE;
+    bool sent = true;
+    int64_t now = esp_timer_get_time();
+    if (channel->mode == ISR_EVENT_CHANNEL_QUEUE) {
+        isr_event_t evt = {
+            .id = id,
+            .data = data,
+            .isr_time_us = now,
+        };
+        // FreeRTOS API: xQueueSendFromISR - the last parameter tells whether a higher priority task was woken
+        sent = xQueueSendFromISR(channel->queue, &evt, &woken) == pdTRUE;
+        if (!sent) {
+            portENTER_CRITICAL_ISR(&channel->lock);
+            channel->stats.dropped++;
+            portEXIT_CRITICAL_ISR(&channel->lock);
+        }
+    } else if (channel->mode == ISR_EVENT_CHANNEL_RING) {
+        isr_event_t evt = {
+            .id = id,
+            .data = data,
+            .isr_time_us = now,
+        };
+        // no lock: the ring counts its own drops
+        sent = isr_event_ring_push_from_isr(channel->ring, &evt, &woken);
+    } else {
+        uint32_t bit = 1UL << (id & 31);
+        portENTER_CRITICAL_ISR(&channel->lock);
+        bool was_pending = channel->pending & bit;
+        if (was_pending) {
+            channel->stats.merged++;
+        }
+        channel->pending |= bit;
+        channel->stamps[id & 31] = now;
+        channel->data[id & 31] = data;
+        portEXIT_CRITICAL_ISR(&channel->lock);
+        // the handler is already due to look at the pending ids, no need to notify again
+        if (!was_pending) {
+            vTaskNotifyGiveFromISR(channel->handler, &woken);
+        }
+    }
+    // Switch to the woken task right when the ISR returns, instead of at the next tick
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+    return sent;
+}
+
+static void isr_event_channel_record(isr_event_channel_t *channel, const isr_event_t *evt) {
+    int64_t latency = esp_timer_get_time() - evt->isr_time_us;
+    uint32_t latency_us = latency < 0 ? 0 : latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency;
+    uint32_t bucket = latency_us ? 32 - __builtin_clz(latency_us) : 0;
+    if (bucket >= ISR_EVENT_CHANNEL_HIST_BUCKETS) {
+        bucket = ISR_EVENT_CHANNEL_HIST_BUCKETS - 1;
+    }
+    portENTER_CRITICAL(&channel->lock);
+    isr_event_channel_stats_t *stats = &channel->stats;
+    stats->events++;
+    stats->histogram[bucket]++;
+    channel->latency_sum_us += latency_us;
+    if (latency_us < stats->min_us) {
+        stats->min_us = latency_us;
+    }
+    if (latency_us > stats->max_us) {
+        stats->max_us = latency_us;
+    }
+    portEXIT_CRITICAL(&channel->lock);
+}
+
+// Take the lowest pending id, returns false if none is pending
+static bool isr_event_channel_take_pending(isr_event_channel_t *channel, isr_event_t *ret_event) {
+    bool taken = false;
+    portENTER_CRITICAL(&channel->lock);
+    if (channel->pending) {
+        uint32_t id = __builtin_ctz(channel->pending);
+        channel->pending &= ~(1UL << id);
+        ret_event->id = id;
+        ret_event->data = channel->data[id];
+        ret_event->isr_time_us = channel->stamps[id];
+        taken = true;
+    }
+    portEXIT_CRITICAL(&channel->lock);
+    return taken;
+}
+
+bool isr_event_channel_receive(isr_event_channel_handle_t channel, isr_event_t *ret_event, TickType_t timeout) {
+    if (channel->mode == ISR_EVENT_CHANNEL_QUEUE) {
+        if (xQueueReceive(channel->queue, ret_event, timeout) != pdTRUE) {
+            return false;
+        }
+    } else if (channel->mode == ISR_EVENT_CHANNEL_RING) {
+        // one trip into the ring for up to ISR_EVENT_CHANNEL_BATCH events
+        if (channel->batch_pos == channel->batch_len) {
+            channel->batch_pos = 0;
+            channel->batch_len = isr_event_ring_pop_batch(channel->ring, channel->batch, ISR_EVENT_CHANNEL_BATCH);
+            if (channel->batch_len == 0) {
+                if (!spsc_ring_wait(channel->ring, timeout)) {
+                    return false;
+                }
+                channel->batch_len = isr_event_ring_pop_batch(channel->ring, channel->batch, ISR_EVENT_CHANNEL_BATCH);
+            }
+        }
+        *ret_event = channel->batch[channel->batch_pos++];
+    } else {
+        while (!isr_event_channel_take_pending(channel, ret_event)) {
+            // NOTE: A notification can be left over from an id that was already taken, so look again after every wakeup
+            if (ulTaskNotifyTake(pdTRUE, timeout) == 0) {
+                return false;
+            }
+        }
+    }
+    isr_event_channel_record(channel, ret_event);
+    return true;
+}
+
+esp_err_t isr_event_channel_get_stats(isr_event_channel_handle_t channel, isr_event_channel_stats_t *ret_stats) {
+    ESP_RETURN_ON_FALSE(channel && ret_stats, ESP_ERR_INVALID_ARG, TAG_ISR_EVENT, "invalid argument");
+    portENTER_CRITICAL(&channel->lock);
+    *ret_stats = channel->stats;
+    uint64_t sum = channel->latency_sum_us;
+    portEXIT_CRITICAL(&channel->lock);
+    if (channel->ring) {
+        ret_stats->dropped = channel->ring->dropped;
+    }
+    if (ret_stats->events) {
+        ret_stats->avg_us = sum / ret_stats->events;
+    } else {
+        ret_stats->min_us = 0;
+    }
+    return ESP_OK;
+}
+
+void isr_event_channel_print_stats(isr_event_channel_handle_t channel) {
+    isr_event_channel_stats_t stats;
+    if (isr_event_channel_get_stats(channel, &stats) != ESP_OK) {
+        return;
+    }
+    printf("ISR-to-task latency: %lu events, %lu dropped, %lu merged, min %lu us, avg %lu us, max %lu us\n",
+           (unsigned long)stats.events, (unsigned long)stats.dropped, (unsigned long)stats.merged,
+           (unsigned long)stats.min_us, (unsigned long)stats.avg_us, (unsigned long)stats.max_us);
+    for (int i = 0; i < ISR_EVENT_CHANNEL_HIST_BUCKETS; i++) {
+        if (stats.histogram[i]) {
+            if (i == ISR_EVENT_CHANNEL_HIST_BUCKETS - 1) {
+                printf("  >= %6lu us: %lu\n", 1UL << (i - 1), (unsigned long)stats.histogram[i]);
+            } else {
+                printf("  <  %6lu us: %lu\n", 1UL << i, (unsigned long)stats.histogram[i]);
+            }
+        }
+    }
+}
+
+void isr_event_channel_delete(isr_event_channel_handle_t channel) {
+    if (!channel) {
+        return;
+    }
+    if (channel->queue) {
+        vQueueDelete(channel->queue);
+    }
+    spsc_ring_delete(channel->ring);
+    free(channel);
+}
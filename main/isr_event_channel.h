@@ -0,0 +1,65 @@
+#ifndef ISR_EVENT_CHANNEL_H
+#define ISR_EVENT_CHANNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+// Number of latency histogram buckets, bucket N counts latencies below 2^N microseconds, the last one all the rest
+#define ISR_EVENT_CHANNEL_HIST_BUCKETS 16
+
+// How the events travel from the ISR to the handler task
+typedef enum {
+    ISR_EVENT_CHANNEL_QUEUE,  // FreeRTOS queue, every event is kept until the queue is full
+    ISR_EVENT_CHANNEL_NOTIFY, // Task notification bits, repeated events of the same id are merged until the handler takes them
+    ISR_EVENT_CHANNEL_RING,   // Lock-free SPSC ring (spsc_ring.h), one ISR producer only, the handler drains the events in batches
+} isr_event_channel_mode_t;
+
+// An event, stamped in the ISR
+typedef struct {
+    uint32_t id;         // Event id, below 32 in notify mode
+    uint32_t data;       // Event data, in notify mode the data of the latest event of the id
+    int64_t isr_time_us; // esp_timer time when the ISR sent the event
+} isr_event_t;
+
+typedef struct {
+    isr_event_channel_mode_t mode;
+    uint32_t queue_length; // Queue and ring mode: number of events the queue or the ring holds
+    TaskHandle_t handler;  // Notify and ring mode: the only task that receives, its notification value (index 0) is taken over
+} isr_event_channel_config_t;
+
+// Latency from the ISR to the handler task, in microseconds
+typedef struct {
+    uint32_t events;                                // Events received
+    uint32_t dropped;                               // Events lost because the queue or the ring was full
+    uint32_t merged;                                // Events merged into a pending one of the same id (notify mode)
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t avg_us;
+    uint32_t histogram[ISR_EVENT_CHANNEL_HIST_BUCKETS]; // Bucket N: latency below 2^N us
+} isr_event_channel_stats_t;
+
+typedef struct isr_event_channel_t *isr_event_channel_handle_t;
+
+// Create a channel, returns ESP_ERR_INVALID_ARG or ESP_ERR_NO_MEM on failure
+esp_err_t isr_event_channel_create(const isr_event_channel_config_t *config, isr_event_channel_handle_t *ret_channel);
+
+// Send an event from an ISR, and yield at the end of the ISR if the handler task was woken.
+// Returns false if the event was dropped
+bool isr_event_channel_send_from_isr(isr_event_channel_handle_t channel, uint32_t id, uint32_t data);
+
+// Wait for the next event, records its latency. Returns false on timeout
+bool isr_event_channel_receive(isr_event_channel_handle_t channel, isr_event_t *ret_event, TickType_t timeout);
+
+// Copy the latency statistics, can be called from any task
+esp_err_t isr_event_channel_get_stats(isr_event_channel_handle_t channel, isr_event_channel_stats_t *ret_stats);
+
+// Print the latency histogram
+void isr_event_channel_print_stats(isr_event_channel_handle_t channel);
+
+// Delete the channel, no ISR may send to it anymore
+void isr_event_channel_delete(isr_event_channel_handle_t channel);
+
+#endif // ISR_EVENT_CHANNEL_H